@@ -11,6 +11,7 @@
 //
 #include "utils/tools.h"
 #include "alignment.h"
+#include "mappedalignment.h"
 #include "nclextra/myreader.h"
 #include <numeric>
 #include <sstream>
@@ -152,6 +153,16 @@ int Alignment::checkAbsentStates(string msg) {
     return count;
 }
 
+void Alignment::reportAlignment() {
+    if (Params::getInstance().compute_seq_composition)
+        cout << "Alignment has " << getNSeq() << " sequences with " << getNSite()
+             << " columns, " << getNPattern() << " distinct patterns" << endl
+             << num_informative_sites << " parsimony-informative, "
+             << num_variant_sites-num_informative_sites << " singleton sites, "
+             << (int)(frac_const_sites*getNSite()) << " constant sites" << endl;
+    checkSeqName();
+}
+
 void Alignment::checkSeqName() {
     ostringstream warn_str;
     StrVector::iterator it;
@@ -538,13 +549,16 @@ Alignment::Alignment(char *filename, char *sequence_type, InputType &intype, str
             readNexus(filename);
         } else if (intype == IN_FASTA) {
             cout << "Fasta format detected" << endl;
-            readFasta(filename, sequence_type);
+            if (!Params::getInstance().stream_alignment || !readAlignmentStreaming(filename, sequence_type, intype))
+                readFasta(filename, sequence_type);
         } else if (intype == IN_PHYLIP) {
             cout << "Phylip format detected" << endl;
-            if (Params::getInstance().phylip_sequential_format)
-                readPhylipSequential(filename, sequence_type);
-            else
-                readPhylip(filename, sequence_type);
+            if (!Params::getInstance().stream_alignment || !readAlignmentStreaming(filename, sequence_type, intype)) {
+                if (Params::getInstance().phylip_sequential_format)
+                    readPhylipSequential(filename, sequence_type);
+                else
+                    readPhylip(filename, sequence_type);
+            }
         } else if (intype == IN_COUNTS) {
             cout << "Counts format (PoMo) detected" << endl;
             readCountsFormat(filename, sequence_type);
@@ -564,8 +578,12 @@ Alignment::Alignment(char *filename, char *sequence_type, InputType &intype, str
     } catch (string str) {
         outError(str);
     }
-    if (verbose_mode >= VB_MED) {
-        cout << "Time to read input file was " << (getRealTime() - readStart) << " sec." << endl;
+    if (verbose_mode >= VB_MED || Params::getInstance().stream_alignment) {
+        cout << "Time to read input file was " << (getRealTime() - readStart) << " sec";
+        uint64_t peak_mem = getPeakMemoryUsage();
+        if (peak_mem)
+            cout << ", peak memory usage " << convertDoubleToString(peak_mem / 1048576.0) << " MB";
+        cout << "." << endl;
     }
     if (getNSeq() < 3)
     {
@@ -576,16 +594,8 @@ Alignment::Alignment(char *filename, char *sequence_type, InputType &intype, str
     if (verbose_mode >= VB_MED) {
         cout << "Time to count constant sites was " << (getRealTime() - constCountStart) << " sec." << endl;
     }
-    if (Params::getInstance().compute_seq_composition)
-    {
-        cout << "Alignment has " << getNSeq() << " sequences with " << getNSite()
-             << " columns, " << getNPattern() << " distinct patterns" << endl
-             << num_informative_sites << " parsimony-informative, "
-             << num_variant_sites-num_informative_sites << " singleton sites, "
-             << (int)(frac_const_sites*getNSite()) << " constant sites" << endl;
-    }
     //buildSeqStates();
-    checkSeqName();
+    reportAlignment();
     // OBSOLETE: identical sequences are handled later
 //	checkIdenticalSeq();
     //cout << "Number of character states is " << num_states << endl;
@@ -618,14 +628,8 @@ Alignment::Alignment(NxsDataBlock *data_block, char *sequence_type, string model
     
     countConstSite();
     
-    if (Params::getInstance().compute_seq_composition)
-        cout << "Alignment has " << getNSeq() << " sequences with " << getNSite()
-        << " columns, " << getNPattern() << " distinct patterns" << endl
-        << num_informative_sites << " parsimony-informative, "
-        << num_variant_sites-num_informative_sites << " singleton sites, "
-        << (int)(frac_const_sites*getNSite()) << " constant sites" << endl;
     //buildSeqStates();
-    checkSeqName();
+    reportAlignment();
     // OBSOLETE: identical sequences are handled later
     //    checkIdenticalSeq();
     //cout << "Number of character states is " << num_states << endl;
@@ -1288,50 +1292,67 @@ void Alignment::regroupSitePattern(int groups, IntVector& site_group)
 }
 
 
+void Alignment::countSequenceChars(StrVector &sequences, size_t *char_count) {
+    memset(char_count, 0, NUM_CHAR*sizeof(size_t));
+    size_t sequenceCount = sequences.size();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        size_t local_count[NUM_CHAR];
+        memset(local_count, 0, NUM_CHAR*sizeof(size_t));
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (size_t seqNum = 0; seqNum < sequenceCount; ++seqNum) {
+            const unsigned char *start = (const unsigned char*)sequences[seqNum].data();
+            const unsigned char *stop  = start + sequences[seqNum].size();
+            for (const unsigned char *i = start; i != stop; ++i)
+                local_count[*i]++;
+        }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        for (int i = 0; i < NUM_CHAR; i++)
+            char_count[i] += local_count[i];
+    }
+}
+
 /**
 	detect the data type of the input sequences
-	@param sequences vector of strings
+	@param char_count number of occurrences of each character in the sequences
 	@return the data type of the input sequences
 */
-SeqType Alignment::detectSequenceType(StrVector &sequences) {
+SeqType Alignment::detectSequenceType(const size_t *char_count) {
     size_t num_nuc   = 0;
     size_t num_ungap = 0;
     size_t num_bin   = 0;
     size_t num_alpha = 0;
     size_t num_digit = 0;
-    double detectStart = getRealTime();
-    size_t sequenceCount = sequences.size();
-#ifdef _OPENMP
-#pragma omp parallel for reduction(+:num_nuc,num_ungap,num_bin,num_alpha,num_digit)
-#endif
-    for (size_t seqNum = 0; seqNum < sequenceCount; ++seqNum) {
-        auto start = sequences.at(seqNum).data();
-        auto stop  = start + sequences.at(seqNum).size();
-        for (auto i = start; i!=stop; ++i) {
-            if ((*i) == 'A' || (*i) == 'C' || (*i) == 'G' || (*i) == 'T' || (*i) == 'U') {
-                ++num_nuc;
-                ++num_ungap;
-                continue;
-            }
-            if ((*i)=='?' || (*i)=='-' || (*i) == '.' ) {
-                continue;
-            }
-            if (*i != 'N' && *i != 'X' &&  (*i) != '~') {
-                num_ungap++;
-                if (isdigit(*i)) {
-                    num_digit++;
-                    if ((*i) == '0' || (*i) == '1') {
-                        num_bin++;
-                    }
+    for (int i = 0; i < NUM_CHAR; ++i) {
+        size_t count = char_count[i];
+        if (count == 0)
+            continue;
+        if (i == 'A' || i == 'C' || i == 'G' || i == 'T' || i == 'U') {
+            num_nuc += count;
+            num_ungap += count;
+            continue;
+        }
+        if (i == '?' || i == '-' || i == '.' ) {
+            continue;
+        }
+        if (i != 'N' && i != 'X' && i != '~') {
+            num_ungap += count;
+            if (isdigit(i)) {
+                num_digit += count;
+                if (i == '0' || i == '1') {
+                    num_bin += count;
                 }
             }
-            if (isalpha(*i)) {
-                num_alpha++;
-            }
         }
-    }
-    if (verbose_mode >= VB_MED) {
-        cout << "Sequence Type detection took " << (getRealTime()-detectStart) << " seconds." << endl;
+        if (i < 128 && isalpha(i)) {
+            num_alpha += count;
+        }
     }
     if (((double)num_nuc) / num_ungap > 0.9)
         return SEQ_DNA;
@@ -1669,11 +1690,10 @@ void Alignment::initCodon(char *gene_code_id) {
 //	cout << "num_states = " << num_states << endl;
 }
 
-int getMorphStates(StrVector &sequences) {
+int getMorphStates(const size_t *char_count) {
 	char maxstate = 0;
-	for (StrVector::iterator it = sequences.begin(); it != sequences.end(); it++)
-		for (string::iterator pos = it->begin(); pos != it->end(); pos++)
-			if ((*pos) > maxstate && isalnum(*pos)) maxstate = *pos;
+	for (int i = 0; i < 128; i++)
+		if (char_count[i] && i > maxstate && isalnum(i)) maxstate = i;
 	if (maxstate >= '0' && maxstate <= '9') return (maxstate - '0' + 1);
 	if (maxstate >= 'A' && maxstate <= 'V') return (maxstate - 'A' + 11);
 	return 0;
@@ -1722,20 +1742,13 @@ string Alignment::getSeqTypeStr(SeqType sequence_type) {
     }
 }
 
-int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq, int nsite) {
-    int seq_id;
+void Alignment::checkSeqNamesValid() {
+    int nseq = seq_names.size();
     ostringstream err_str;
-    codon_table = NULL;
-    genetic_code = NULL;
-    non_stop_codon = NULL;
-
-    if (nseq != seq_names.size()) {
-        throw "Different number of sequences than specified";
-    }
     unordered_set<string> namesSeen;
     double seqCheckStart = getRealTime();
     /* now check that all sequence names are correct */
-    for (seq_id = 0; seq_id < nseq; seq_id ++) {
+    for (int seq_id = 0; seq_id < nseq; seq_id ++) {
         ostringstream err_str;
         if (seq_names[seq_id] == "")
             err_str << "Sequence number " << seq_id+1 << " has no names\n";
@@ -1752,6 +1765,19 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
         cout.precision(6);
         cout << "Duplicate sequence name check took " << (getRealTime()-seqCheckStart) << " seconds." << endl;
     }
+}
+
+int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq, int nsite) {
+    int seq_id;
+    ostringstream err_str;
+    codon_table = NULL;
+    genetic_code = NULL;
+    non_stop_codon = NULL;
+
+    if (nseq != seq_names.size()) {
+        throw "Different number of sequences than specified";
+    }
+    checkSeqNamesValid();
     /* now check that all sequences have the same length */
     for (seq_id = 0; seq_id < nseq; seq_id ++) {
         if (sequences[seq_id].length() != nsite) {
@@ -1769,7 +1795,36 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
         throw err_str.str();
 
     /* now check data type */
-    seq_type = detectSequenceType(sequences);
+    size_t char_count[NUM_CHAR];
+    countSequenceChars(sequences, char_count);
+    char char_to_state[NUM_CHAR];
+    char AA_to_state[NUM_CHAR];
+    bool nt2aa = initSequenceType(char_count, sequence_type, char_to_state, AA_to_state);
+
+    // now convert to patterns
+    int step = ((seq_type == SEQ_CODON || nt2aa) ? 3 : 1);
+    if (nsite % step != 0)
+    	outError("Number of sites is not multiple of 3");
+    site_pattern.resize(nsite/step, -1);
+    clear();
+    pattern_index.clear();
+    int num_error = 0, num_gaps_only = 0;
+    
+    progress_display progress(nsite, "Constructing alignment", "examined", "site");
+    addPatternsFromSequences(sequences, 0, nsite, nt2aa, char_to_state, AA_to_state,
+                             err_str, num_error, num_gaps_only, &progress);
+    progress.done();
+    finishPatterns(err_str, num_gaps_only);
+    return 1;
+}
+
+bool Alignment::initSequenceType(const size_t *char_count, char *sequence_type,
+                                 char *char_to_state, char *AA_to_state) {
+    double detectStart = getRealTime();
+    seq_type = detectSequenceType(char_count);
+    if (verbose_mode >= VB_MED) {
+        cout << "Sequence Type detection took " << (getRealTime()-detectStart) << " seconds." << endl;
+    }
     switch (seq_type) {
     case SEQ_BINARY:
         num_states = 2;
@@ -1784,7 +1839,7 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
         cout << "Alignment most likely contains protein sequences" << endl;
         break;
     case SEQ_MORPH:
-        num_states = getMorphStates(sequences);
+        num_states = getMorphStates(char_count);
         if (num_states < 2 || num_states > 32) throw "Invalid number of states.";
         cout << "Alignment most likely contains " << num_states << "-state morphological data" << endl;
         break;
@@ -1816,7 +1871,7 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
             nt2aa = true;
             cout << "Translating to amino-acid sequences with genetic code " << &sequence_type[5] << " ..." << endl;
         } else if (strcmp(sequence_type, "NUM") == 0 || strcmp(sequence_type, "MORPH") == 0) {
-            num_states = getMorphStates(sequences);
+            num_states = getMorphStates(char_count);
             if (num_states < 2 || num_states > 32) throw "Invalid number of states";
             user_seq_type = SEQ_MORPH;
         } else if (strcmp(sequence_type, "TINA") == 0 || strcmp(sequence_type, "MULTI") == 0) {
@@ -1836,30 +1891,30 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
     }
 
     //initStateSpace(seq_type);
-    
-    // now convert to patterns
-    int site, seq, num_gaps_only = 0;
 
-    char char_to_state[NUM_CHAR];
-    char AA_to_state[NUM_CHAR];
     computeUnknownState();
     if (nt2aa) {
         buildStateMap(char_to_state, SEQ_DNA);
         buildStateMap(AA_to_state, SEQ_PROTEIN);
     } else
         buildStateMap(char_to_state, seq_type);
+    return nt2aa;
+}
 
+void Alignment::addPatternsFromSequences(StrVector &sequences, int first_site, int nsite, bool nt2aa,
+                                         char *char_to_state, char *AA_to_state, ostringstream &err_str,
+                                         int &num_error, int &num_gaps_only, progress_display *progress) {
+    int site, seq;
+    int nseq = sequences.size();
+    int step = ((seq_type == SEQ_CODON || nt2aa) ? 3 : 1);
+    if (num_error == 0 && verbose_mode < VB_DEBUG &&
+        addPatternsParallel(sequences, first_site, nsite, nt2aa, char_to_state, AA_to_state, num_gaps_only)) {
+        if (progress)
+            (*progress) += nsite;
+        return;
+    }
     Pattern pat;
     pat.resize(nseq);
-    int step = ((seq_type == SEQ_CODON || nt2aa) ? 3 : 1);
-    if (nsite % step != 0)
-    	outError("Number of sites is not multiple of 3");
-    site_pattern.resize(nsite/step, -1);
-    clear();
-    pattern_index.clear();
-    int num_error = 0;
-    
-    progress_display progress(nsite, "Constructing alignment", "examined", "site");
     for (site = 0; site < nsite; site+=step) {
         for (seq = 0; seq < nseq; seq++) {
             //char state = convertState(sequences[seq][site], seq_type);
@@ -1874,7 +1929,7 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
             		if (genetic_code[(int)state] == '*') {
                         err_str << "Sequence " << seq_names[seq] << " has stop codon " <<
                         		sequences[seq][site] << sequences[seq][site+1] << sequences[seq][site+2] <<
-                        		" at site " << site+1 << endl;
+                        		" at site " << first_site+site+1 << endl;
                         num_error++;
                         state = STATE_UNKNOWN;
             		} else if (nt2aa) {
@@ -1889,7 +1944,7 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
             			ostringstream warn_str;
                         warn_str << "Sequence " << seq_names[seq] << " has ambiguous character " <<
                         		sequences[seq][site] << sequences[seq][site+1] << sequences[seq][site+2] <<
-                        		" at site " << site+1;
+                        		" at site " << first_site+site+1;
                         outWarning(warn_str.str());
             		}
             		state = STATE_UNKNOWN;
@@ -1900,7 +1955,7 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
                     err_str << "Sequence " << seq_names[seq] << " has invalid character " << sequences[seq][site];
                     if (seq_type == SEQ_CODON)
                         err_str << sequences[seq][site+1] << sequences[seq][site+2];
-                    err_str << " at site " << site+1 << endl;
+                    err_str << " at site " << first_site+site+1 << endl;
                 } else if (num_error == 100)
                     err_str << "...many more..." << endl;
                 num_error++;
@@ -1910,12 +1965,130 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
         if (!num_error)
         {
             bool gaps_only;
-            addPatternLazy(pat, site/step, 1, gaps_only);
+            addPatternLazy(pat, (first_site+site)/step, 1, gaps_only);
             num_gaps_only += gaps_only ? 1 : 0;
         }
-        progress += step;
+        if (progress)
+            (*progress) += step;
     }
-    progress.done();
+}
+
+bool Alignment::addPatternsParallel(StrVector &sequences, int first_site, int nsite, bool nt2aa,
+                                    char *char_to_state, char *AA_to_state, int &num_gaps_only) {
+#ifdef _OPENMP
+    int nseq = sequences.size();
+    int step = ((seq_type == SEQ_CODON || nt2aa) ? 3 : 1);
+    int ncol = nsite / step;
+    int num_chunks = min(omp_get_max_threads(), ncol / MIN_COLUMNS_PER_THREAD);
+    if (num_chunks < 2)
+        return false;
+
+    // each chunk of consecutive columns gets its own pattern table, in order of first occurrence
+    vector<vector<Pattern> > chunk_patterns(num_chunks);
+    vector<IntVector> chunk_col_pattern(num_chunks);
+    bool failed = false;
+
+#pragma omp parallel for schedule(static, 1) num_threads(num_chunks)
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        int col_begin = (int64_t)ncol * chunk / num_chunks;
+        int col_end = (int64_t)ncol * (chunk+1) / num_chunks;
+        vector<Pattern> &patterns = chunk_patterns[chunk];
+        IntVector &col_pattern = chunk_col_pattern[chunk];
+        col_pattern.resize(col_end - col_begin);
+        PatternIntMap local_index;
+        Pattern pat;
+        pat.resize(nseq);
+        bool local_failed = false;
+        for (int col = col_begin; col < col_end && !local_failed; col++) {
+            int site = col * step;
+            for (int seq = 0; seq < nseq; seq++) {
+                const char *chars = sequences[seq].c_str() + site;
+                char state = char_to_state[(int)chars[0]];
+                if (step == 3) {
+                    char state2 = char_to_state[(int)chars[1]];
+                    char state3 = char_to_state[(int)chars[2]];
+                    if (state < 4 && state2 < 4 && state3 < 4) {
+                        state = state*16 + state2*4 + state3;
+                        if (genetic_code[(int)state] == '*')
+                            local_failed = true;
+                        else if (nt2aa)
+                            state = AA_to_state[(int)genetic_code[(int)state]];
+                        else
+                            state = non_stop_codon[(int)state];
+                    } else if (state == STATE_UNKNOWN && state2 == STATE_UNKNOWN && state3 == STATE_UNKNOWN) {
+                        state = STATE_UNKNOWN;
+                    } else {
+                        // invalid or partially ambiguous codon
+                        local_failed = true;
+                    }
+                }
+                if (state == STATE_INVALID)
+                    local_failed = true;
+                if (local_failed)
+                    break;
+                pat[seq] = state;
+            }
+            if (local_failed)
+                break;
+            PatternIntMap::iterator pat_it = local_index.find(pat);
+            if (pat_it == local_index.end()) {
+                pat.frequency = 1;
+                patterns.push_back(pat);
+                local_index[patterns.back()] = patterns.size()-1;
+                col_pattern[col - col_begin] = patterns.size()-1;
+            } else {
+                patterns[pat_it->second].frequency++;
+                col_pattern[col - col_begin] = pat_it->second;
+            }
+        }
+        if (local_failed) {
+#pragma omp critical
+            failed = true;
+        }
+    }
+    if (failed) {
+        // let the serial code report errors and warnings in site order
+        return false;
+    }
+
+    // merge the chunk tables in column order, which gives the same pattern order as the serial code
+    int col_offset = first_site / step;
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        vector<Pattern> &patterns = chunk_patterns[chunk];
+        IntVector local_to_global(patterns.size());
+        for (size_t i = 0; i < patterns.size(); i++) {
+            Pattern &pat = patterns[i];
+            bool gaps_only = true;
+            for (Pattern::iterator it = pat.begin(); it != pat.end(); it++)
+                if ((*it) != STATE_UNKNOWN) {
+                    gaps_only = false;
+                    break;
+                }
+            if (gaps_only)
+                num_gaps_only += pat.frequency;
+            PatternIntMap::iterator pat_it = pattern_index.find(pat);
+            if (pat_it == pattern_index.end()) {
+                push_back(pat);
+                pattern_index[back()] = size()-1;
+                local_to_global[i] = size()-1;
+            } else {
+                at(pat_it->second).frequency += pat.frequency;
+                local_to_global[i] = pat_it->second;
+            }
+        }
+        vector<Pattern>().swap(patterns);
+        int col_begin = (int64_t)ncol * chunk / num_chunks;
+        IntVector &col_pattern = chunk_col_pattern[chunk];
+        for (size_t col = 0; col < col_pattern.size(); col++)
+            site_pattern[col_offset + col_begin + col] = local_to_global[col_pattern[col]];
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Alignment::finishPatterns(ostringstream &err_str, int num_gaps_only) {
     updatePatterns(0);
     if (num_gaps_only) {
         cout << "WARNING: " << num_gaps_only << " sites contain only gaps or ambiguous characters." << endl;
@@ -1923,7 +2096,6 @@ int Alignment::buildPattern(StrVector &sequences, char *sequence_type, int nseq,
     if (err_str.str() != "") {
         throw err_str.str();
     }
-    return 1;
 }
 
 void processSeq(string &sequence, string &line, int line_num) {
@@ -2103,6 +2275,50 @@ int Alignment::readPhylipSequential(char *filename, char *sequence_type) {
     return buildPattern(sequences, sequence_type, nseq, nsite);
 }
 
+void Alignment::shortenSeqNames() {
+    int i, step = 0;
+    StrVector new_seq_names, remain_seq_names;
+    new_seq_names.resize(seq_names.size());
+    remain_seq_names = seq_names;
+
+    double startShorten = getRealTime();
+    for (step = 0; step < 4; step++) {
+        bool duplicated = false;
+        unordered_set<string> namesSeenThisTime;
+        //Set of shorted names seen so far, this iteration
+        for (i = 0; i < seq_names.size(); i++) {
+            if (remain_seq_names[i].empty()) continue;
+            size_t pos = remain_seq_names[i].find_first_of(" \t");
+            if (pos == string::npos) {
+                new_seq_names[i] += remain_seq_names[i];
+                remain_seq_names[i] = "";
+            } else {
+                new_seq_names[i] += remain_seq_names[i].substr(0, pos);
+                remain_seq_names[i] = "_" + remain_seq_names[i].substr(pos+1);
+            }
+            if (!duplicated) {
+                //add the shortened name for sequence i to the
+                //set of shortened names seen so far, and set
+                //duplicated to true if it was already there.
+                duplicated = !namesSeenThisTime.insert(new_seq_names[i]).second;
+            }
+        }
+        if (!duplicated) break;
+    }
+    if (verbose_mode >= VB_MED) {
+        cout.precision(6);
+        cout << "Name shortening took " << (getRealTime() - startShorten) << " seconds." << endl;
+    }
+    if (step > 0) {
+        for (i = 0; i < seq_names.size(); i++)
+            if (seq_names[i] != new_seq_names[i]) {
+                cout << "NOTE: Change sequence name '" << seq_names[i] << "' -> " << new_seq_names[i] << endl;
+            }
+    }
+
+    seq_names = new_seq_names;
+}
+
 void Alignment::doReadFasta(char *filename, char *sequence_type, StrVector &sequences, int &nseq, int &nsite){
     ostringstream err_str;
     igzstream in;
@@ -2153,47 +2369,7 @@ void Alignment::doReadFasta(char *filename, char *sequence_type, StrVector &sequ
     in.close();
 
     // now try to cut down sequence name if possible
-    int i, step = 0;
-    StrVector new_seq_names, remain_seq_names;
-    new_seq_names.resize(seq_names.size());
-    remain_seq_names = seq_names;
-
-    double startShorten = getRealTime();
-    for (step = 0; step < 4; step++) {
-        bool duplicated = false;
-        unordered_set<string> namesSeenThisTime;
-        //Set of shorted names seen so far, this iteration
-        for (i = 0; i < seq_names.size(); i++) {
-            if (remain_seq_names[i].empty()) continue;
-            size_t pos = remain_seq_names[i].find_first_of(" \t");
-            if (pos == string::npos) {
-                new_seq_names[i] += remain_seq_names[i];
-                remain_seq_names[i] = "";
-            } else {
-                new_seq_names[i] += remain_seq_names[i].substr(0, pos);
-                remain_seq_names[i] = "_" + remain_seq_names[i].substr(pos+1);
-            }
-            if (!duplicated) {
-                //add the shortened name for sequence i to the
-                //set of shortened names seen so far, and set
-                //duplicated to true if it was already there.
-                duplicated = !namesSeenThisTime.insert(new_seq_names[i]).second;
-            }
-        }
-        if (!duplicated) break;
-    }
-    if (verbose_mode >= VB_MED) {
-        cout.precision(6);
-        cout << "Name shortening took " << (getRealTime() - startShorten) << " seconds." << endl;
-    }
-    if (step > 0) {
-        for (i = 0; i < seq_names.size(); i++)
-            if (seq_names[i] != new_seq_names[i]) {
-                cout << "NOTE: Change sequence name '" << seq_names[i] << "' -> " << new_seq_names[i] << endl;
-            }
-    }
-
-    seq_names = new_seq_names;
+    shortenSeqNames();
     
     nseq = seq_names.size();
     nsite = sequences.front().length();
@@ -2211,6 +2387,78 @@ int Alignment::readFasta(char *filename, char *sequence_type) {
     return buildPattern(sequences, sequence_type, nseq, nsite);
 }
 
+int Alignment::readAlignmentStreaming(char *filename, char *sequence_type, InputType intype) {
+    if (sequence_type && (strcmp(sequence_type, "TINA") == 0 || strcmp(sequence_type, "MULTI") == 0))
+        return 0;
+    MappedAlignmentFile file;
+    if (!file.open(filename))
+        return 0;
+    size_t char_count[NUM_CHAR];
+    memset(char_count, 0, sizeof(char_count));
+    int nsite = 0;
+    bool indexed;
+    if (intype == IN_FASTA)
+        indexed = file.indexFasta(seq_names, char_count);
+    else
+        indexed = file.indexPhylip(Params::getInstance().phylip_sequential_format, seq_names, nsite, char_count);
+    if (!indexed) {
+        // fall back to the standard reader
+        seq_names.clear();
+        return 0;
+    }
+    if (intype == IN_FASTA) {
+        shortenSeqNames();
+        nsite = file.getSeqLength(0);
+    }
+    int nseq = seq_names.size();
+    checkSeqNamesValid();
+
+    /* now check that all sequences have the same length */
+    ostringstream err_str;
+    for (int seq_id = 0; seq_id < nseq; seq_id ++) {
+        size_t len = file.getSeqLength(seq_id);
+        if (len != nsite) {
+            err_str << "Sequence " << seq_names[seq_id] << " contains ";
+            if (len < nsite)
+                err_str << "not enough";
+            else
+                err_str << "too many";
+            err_str << " characters (" << len << ")\n";
+        }
+    }
+    if (err_str.str() != "")
+        throw err_str.str();
+
+    char char_to_state[NUM_CHAR];
+    char AA_to_state[NUM_CHAR];
+    bool nt2aa = initSequenceType(char_count, sequence_type, char_to_state, AA_to_state);
+
+    int step = ((seq_type == SEQ_CODON || nt2aa) ? 3 : 1);
+    if (nsite % step != 0)
+    	outError("Number of sites is not multiple of 3");
+    site_pattern.resize(nsite/step, -1);
+    clear();
+    pattern_index.clear();
+    int num_error = 0, num_gaps_only = 0;
+
+    // about 64 MB of characters per block, a multiple of the codon length
+    size_t block_sites = ((size_t)64 << 20) / nseq;
+    block_sites = max((size_t)step, block_sites - block_sites % step);
+
+    progress_display progress(nsite, "Constructing alignment", "examined", "site");
+    StrVector block;
+    for (size_t first_site = 0; first_site < nsite; first_site += block_sites) {
+        size_t num_sites = min(block_sites, nsite - first_site);
+        file.readBlock(first_site, num_sites, block);
+        addPatternsFromSequences(block, first_site, num_sites, nt2aa, char_to_state, AA_to_state,
+                                 err_str, num_error, num_gaps_only, &progress);
+    }
+    progress.done();
+    file.close();
+    finishPatterns(err_str, num_gaps_only);
+    return 1;
+}
+
 void Alignment::doReadClustal(char *filename, char *sequence_type, StrVector &sequences, int &nseq, int &nsite){
     igzstream in;
     int line_num = 1;
@@ -21,7 +21,12 @@
 const double MIN_FREQUENCY          = 0.0001;
 const double MIN_FREQUENCY_DIFF     = 0.00001;
 
+class progress_display;
+
 const int NUM_CHAR = 256;
+
+/** minimal number of alignment columns per thread for multi-threaded pattern construction */
+const int MIN_COLUMNS_PER_THREAD = 1000;
 typedef bitset<NUM_CHAR> StateBitset;
 
 /** class storing results of symmetry tests */
@@ -97,6 +102,7 @@ Multiple Sequence Alignment. Stored by a vector of site-patterns
 class Alignment : public vector<Pattern>, public CharSet, public StateSpace {
     friend class SuperAlignment;
     friend class SuperAlignmentUnlinked;
+    friend class AlignmentCache;
 
 public:
 
@@ -200,6 +206,73 @@ public:
     int readNexus(char *filename);
 
     int buildPattern(StrVector &sequences, char *sequence_type, int nseq, int nsite);
+
+    /**
+            check that all sequence names are non-empty and distinct
+     */
+    void checkSeqNamesValid();
+
+    /**
+            count the occurrences of each character in the sequences
+            @param sequences input sequences
+            @param[out] char_count array of NUM_CHAR counts
+     */
+    void countSequenceChars(StrVector &sequences, size_t *char_count);
+
+    /**
+            detect (or take from the user) the sequence type and initialize the state space
+            @param char_count number of occurrences of each character in the alignment
+            @param sequence_type user-specified sequence type or NULL
+            @param[out] char_to_state map from characters to states
+            @param[out] AA_to_state map from amino-acids to states (only for NT2AA)
+            @return TRUE if DNA is to be translated into amino-acids (NT2AA)
+     */
+    bool initSequenceType(const size_t *char_count, char *sequence_type,
+                          char *char_to_state, char *AA_to_state);
+
+    /**
+            convert columns [first_site, first_site+nsite) into patterns;
+            site_pattern must already have been resized
+            @param sequences the columns of all sequences, starting at first_site
+            @param first_site index of the first column within the whole alignment
+            @param nsite number of columns
+            @param[in,out] err_str, num_error, num_gaps_only accumulated errors and gap-only sites
+            @param progress progress bar to advance, or NULL
+     */
+    void addPatternsFromSequences(StrVector &sequences, int first_site, int nsite, bool nt2aa,
+                                  char *char_to_state, char *AA_to_state, ostringstream &err_str,
+                                  int &num_error, int &num_gaps_only, progress_display *progress);
+
+    /**
+            multi-threaded version of addPatternsFromSequences() for alignments without errors:
+            each thread hashes a contiguous chunk of columns into a local pattern table, the
+            tables are then merged in column order so that the pattern order is the same as
+            with a single thread
+            @return FALSE (nothing added) if there are too few columns or some column has
+            invalid/ambiguous characters that must be reported by the serial code
+     */
+    bool addPatternsParallel(StrVector &sequences, int first_site, int nsite, bool nt2aa,
+                             char *char_to_state, char *AA_to_state, int &num_gaps_only);
+
+    /**
+            finalize patterns after all columns have been added, throws accumulated errors
+     */
+    void finishPatterns(ostringstream &err_str, int num_gaps_only);
+
+    /**
+            read a PHYLIP or FASTA alignment via a memory-mapped file, building patterns
+            block-by-block of columns, so that the sequences are never held in memory
+            @param filename file name
+            @param sequence_type type of the sequence, either "BIN", "DNA", "AA", or NULL
+            @param intype IN_PHYLIP or IN_FASTA
+            @return 1 on success, 0 if the file must be read by the standard reader
+     */
+    int readAlignmentStreaming(char *filename, char *sequence_type, InputType intype);
+
+    /**
+            shorten FASTA sequence names to their first word(s), as long as they stay unique
+     */
+    void shortenSeqNames();
     
     /**
             do-read the alignment in PHYLIP format (interleaved)
@@ -335,7 +408,7 @@ public:
     /****************************************************************************
             output alignment 
      ****************************************************************************/
-    SeqType detectSequenceType(StrVector &sequences);
+    SeqType detectSequenceType(const size_t *char_count);
 
     void computeUnknownState();
 
@@ -490,6 +563,12 @@ public:
     */
     virtual int checkAbsentStates(string msg);
 
+    /**
+            print the site counts, check sequence names and compositions;
+            called after countConstSite() once the alignment is read or restored
+     */
+    void reportAlignment();
+
     /**
             check proper and undupplicated sequence names
      */
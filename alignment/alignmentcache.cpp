@@ -0,0 +1,373 @@
+//
+// C++ Implementation: alignmentcache
+//
+// Description: binary cache of compressed alignments for fast restarts
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#include "alignmentcache.h"
+#include "mappedalignment.h"
+#include "utils/MPIHelper.h"
+#include "utils/timeutil.h"
+#include <algorithm>
+#include <cstdio>
+
+const uint32_t ALN_CACHE_BYTE_ORDER = 0x01020304;
+
+/** 64-bit FNV-style hash, consuming 8 bytes per step */
+static uint64_t hashBytes(const char *data, size_t len, uint64_t hash = 0xcbf29ce484222325ULL) {
+    const uint64_t prime = 0x100000001b3ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < len; i++)
+        hash = (hash ^ (unsigned char)data[i]) * prime;
+    return hash;
+}
+
+static uint64_t hashString(const string &str, uint64_t hash) {
+    uint64_t len = str.length();
+    hash = hashBytes((const char*)&len, sizeof(len), hash);
+    return hashBytes(str.data(), str.length(), hash);
+}
+
+/** helper to write the binary cache */
+class CacheWriter {
+public:
+    CacheWriter(ostream &out) : out(out) {}
+
+    template<class T> void put(const T &value) {
+        out.write((const char*)&value, sizeof(T));
+    }
+
+    template<class T> void putArray(const T *values, size_t num) {
+        if (num)
+            out.write((const char*)values, num*sizeof(T));
+    }
+
+    void putString(const string &str) {
+        put((uint64_t)str.length());
+        putArray(str.data(), str.length());
+    }
+
+    ostream &out;
+};
+
+/** helper to read the memory-mapped binary cache; throws on truncated data */
+class CacheReader {
+public:
+    CacheReader(const char *data, size_t length) : pos(data), end(data + length) {}
+
+    void require(size_t num) {
+        if ((size_t)(end - pos) < num)
+            throw "Alignment cache file is truncated";
+    }
+
+    template<class T> T get() {
+        T value;
+        require(sizeof(T));
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template<class T> const char *getArray(size_t num) {
+        if (num > (size_t)(end - pos) / sizeof(T))
+            throw "Alignment cache file is truncated";
+        const char *ptr = pos;
+        pos += num*sizeof(T);
+        return ptr;
+    }
+
+    string getString() {
+        uint64_t len = get<uint64_t>();
+        return string(getArray<char>(len), len);
+    }
+
+    const char *pos;
+    const char *end;
+};
+
+bool AlignmentCache::isEnabled(Params &params) {
+    return params.aln_cache && params.out_prefix && !params.alisim_active &&
+        (params.aln_file || params.partition_file);
+}
+
+string AlignmentCache::getFileName(Params &params) {
+    return (string)params.out_prefix + ".alncache";
+}
+
+bool AlignmentCache::computeChecksum(SourceFile &src) {
+    MappedFile file;
+    if (!file.open(src.name.c_str()))
+        return false;
+    src.size = file.getLength();
+    src.checksum = hashBytes(file.getData(), file.getLength());
+    return true;
+}
+
+void AlignmentCache::addSourceFiles(const string &name, StrVector &files) {
+    if (name.empty())
+        return;
+    StrVector names;
+    if (name.find(',') != string::npos)
+        convert_string_vec(name.c_str(), names);
+    else
+        names.push_back(name);
+    for (auto it = names.begin(); it != names.end(); it++) {
+        StrVector dir_files;
+        if (isDirectory(it->c_str())) {
+            string dir = *it;
+            if (dir.back() != '/')
+                dir.append("/");
+            getFilesInDir(it->c_str(), dir_files);
+            std::sort(dir_files.begin(), dir_files.end());
+            for (auto fit = dir_files.begin(); fit != dir_files.end(); fit++)
+                *fit = dir + *fit;
+        } else
+            dir_files.push_back(*it);
+        for (auto fit = dir_files.begin(); fit != dir_files.end(); fit++)
+            if (std::find(files.begin(), files.end(), *fit) == files.end())
+                files.push_back(*fit);
+    }
+}
+
+uint64_t AlignmentCache::getOptionHash(Params &params) {
+    uint64_t hash = hashString(params.aln_file ? params.aln_file : "", 0xcbf29ce484222325ULL);
+    hash = hashString(params.partition_file ? params.partition_file : "", hash);
+    hash = hashString(params.sequence_type ? params.sequence_type : "", hash);
+    hash = hashString(params.model_name, hash);
+    int64_t flags[] = {params.intype, params.remove_empty_seq, params.phylip_sequential_format};
+    return hashBytes((const char*)flags, sizeof(flags), hash);
+}
+
+bool AlignmentCache::isSupported(Alignment *aln) {
+    if (aln->isSuperAlignment() || aln->seq_type == SEQ_POMO)
+        return false;
+    if (aln->genetic_code) {
+        // genetic code is restored from the sequence type, e.g. CODON2 or NT2AA11
+        string prefix = aln->sequence_type.substr(0, 5);
+        if (prefix != "CODON" && prefix != "NT2AA")
+            return false;
+    }
+    return true;
+}
+
+bool AlignmentCache::save(Params &params, vector<Alignment*> &alns) {
+    if (!isEnabled(params) || !MPIHelper::getInstance().isMaster() || alns.empty())
+        return false;
+    for (auto it = alns.begin(); it != alns.end(); it++)
+        if (!isSupported(*it))
+            return false;
+
+    double start_time = getRealTime();
+
+    // all files the alignments were read from
+    StrVector names;
+    addSourceFiles(params.aln_file ? params.aln_file : "", names);
+    addSourceFiles(params.partition_file ? params.partition_file : "", names);
+    for (auto it = alns.begin(); it != alns.end(); it++)
+        addSourceFiles((*it)->aln_file, names);
+    vector<SourceFile> sources(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        sources[i].name = names[i];
+        if (!computeChecksum(sources[i]))
+            return false;
+    }
+
+    string filename = getFileName(params);
+    string filename_tmp = filename + ".tmp";
+    try {
+        ofstream out;
+        out.exceptions(ios::failbit | ios::badbit);
+        out.open(filename_tmp.c_str(), ios::out | ios::binary);
+        CacheWriter writer(out);
+        writer.putArray(ALN_CACHE_MAGIC, 8);
+        writer.put(ALN_CACHE_VERSION);
+        writer.put(ALN_CACHE_BYTE_ORDER);
+        writer.put((uint32_t)sizeof(StateType));
+        writer.put(getOptionHash(params));
+        writer.put((uint64_t)sources.size());
+        for (auto it = sources.begin(); it != sources.end(); it++) {
+            writer.putString(it->name);
+            writer.put(it->size);
+            writer.put(it->checksum);
+        }
+        writer.put((uint64_t)alns.size());
+        for (auto it = alns.begin(); it != alns.end(); it++) {
+            Alignment *aln = *it;
+            writer.putString(aln->name);
+            writer.putString(aln->model_name);
+            writer.putString(aln->aln_file);
+            writer.putString(aln->sequence_type);
+            writer.putString(aln->position_spec);
+            writer.putString(aln->char_partition);
+            writer.put(aln->tree_len);
+            writer.put((int32_t)aln->seq_type);
+            writer.put((int32_t)aln->num_states);
+            writer.put((uint32_t)aln->STATE_UNKNOWN);
+            uint64_t nseq = aln->getNSeq(), nptn = aln->getNPattern(), nsite = aln->getNSite();
+            writer.put(nseq);
+            writer.put(nptn);
+            writer.put(nsite);
+            for (uint64_t seq = 0; seq < nseq; seq++)
+                writer.putString(aln->getSeqName(seq));
+            for (uint64_t ptn = 0; ptn < nptn; ptn++)
+                writer.putArray(&aln->at(ptn)[0], nseq);
+            for (uint64_t ptn = 0; ptn < nptn; ptn++)
+                writer.put((int32_t)aln->at(ptn).frequency);
+            for (uint64_t ptn = 0; ptn < nptn; ptn++)
+                writer.put((int32_t)aln->at(ptn).flag);
+            for (uint64_t ptn = 0; ptn < nptn; ptn++)
+                writer.put(aln->at(ptn).const_char);
+            for (uint64_t ptn = 0; ptn < nptn; ptn++)
+                writer.put((int32_t)aln->at(ptn).num_chars);
+            for (uint64_t site = 0; site < nsite; site++)
+                writer.put((int32_t)aln->getPatternID(site));
+        }
+        writer.putArray(ALN_CACHE_MAGIC, 8);
+        out.close();
+        if (fileExists(filename) && std::remove(filename.c_str()) != 0)
+            return false;
+        if (std::rename(filename_tmp.c_str(), filename.c_str()) != 0)
+            return false;
+    } catch (ios::failure &) {
+        outWarning("Cannot write alignment cache file " + filename);
+        std::remove(filename_tmp.c_str());
+        return false;
+    }
+    if (verbose_mode >= VB_MED)
+        cout << "Alignment cache written to " << filename << " in "
+             << getRealTime() - start_time << " sec" << endl;
+    return true;
+}
+
+bool AlignmentCache::load(Params &params, vector<Alignment*> &alns) {
+    if (!isEnabled(params) || params.ignore_checkpoint)
+        return false;
+    string filename = getFileName(params);
+    if (!fileExists(filename))
+        return false;
+    double start_time = getRealTime();
+    MappedFile file;
+    if (!file.open(filename.c_str()))
+        return false;
+    vector<Alignment*> loaded;
+    try {
+        CacheReader reader(file.getData(), file.getLength());
+        if (memcmp(reader.getArray<char>(8), ALN_CACHE_MAGIC, 8) != 0)
+            throw "wrong file type";
+        if (reader.get<uint32_t>() != ALN_CACHE_VERSION ||
+            reader.get<uint32_t>() != ALN_CACHE_BYTE_ORDER ||
+            reader.get<uint32_t>() != sizeof(StateType))
+            throw "incompatible version";
+        if (reader.get<uint64_t>() != getOptionHash(params))
+            throw "options changed";
+
+        // source files must be unchanged
+        StrVector required;
+        addSourceFiles(params.aln_file ? params.aln_file : "", required);
+        addSourceFiles(params.partition_file ? params.partition_file : "", required);
+        uint64_t num_sources = reader.get<uint64_t>();
+        StrVector names;
+        for (uint64_t i = 0; i < num_sources; i++) {
+            SourceFile src;
+            src.name = reader.getString();
+            uint64_t size = reader.get<uint64_t>();
+            uint64_t checksum = reader.get<uint64_t>();
+            if (!computeChecksum(src) || src.size != size || src.checksum != checksum)
+                throw "source file " + src.name + " changed";
+            names.push_back(src.name);
+        }
+        for (auto it = required.begin(); it != required.end(); it++)
+            if (std::find(names.begin(), names.end(), *it) == names.end())
+                throw "source file " + *it + " not recorded";
+
+        uint64_t num_alns = reader.get<uint64_t>();
+        if (num_alns == 0 || (!params.partition_file && num_alns != 1))
+            throw "wrong number of alignments";
+        for (uint64_t i = 0; i < num_alns; i++) {
+            Alignment *aln = new Alignment();
+            loaded.push_back(aln);
+            aln->name = reader.getString();
+            aln->model_name = reader.getString();
+            aln->aln_file = reader.getString();
+            aln->sequence_type = reader.getString();
+            aln->position_spec = reader.getString();
+            aln->char_partition = reader.getString();
+            aln->tree_len = reader.get<double>();
+            aln->seq_type = (SeqType)reader.get<int32_t>();
+            int num_states = reader.get<int32_t>();
+            aln->STATE_UNKNOWN = reader.get<uint32_t>();
+            uint64_t nseq = reader.get<uint64_t>();
+            uint64_t nptn = reader.get<uint64_t>();
+            uint64_t nsite = reader.get<uint64_t>();
+            for (uint64_t seq = 0; seq < nseq; seq++)
+                aln->seq_names.push_back(reader.getString());
+            if (aln->genetic_code == NULL && aln->sequence_type.length() >= 5 &&
+                (aln->sequence_type.substr(0, 5) == "CODON" || aln->sequence_type.substr(0, 5) == "NT2AA")) {
+                string code = aln->sequence_type.substr(5);
+                aln->initCodon((char*)code.c_str());
+            }
+            aln->num_states = num_states;
+
+            const char *states = reader.getArray<StateType>(nptn*nseq);
+            const char *freqs = reader.getArray<int32_t>(nptn);
+            const char *flags = reader.getArray<int32_t>(nptn);
+            const char *const_chars = reader.getArray<char>(nptn);
+            const char *num_chars = reader.getArray<int32_t>(nptn);
+            const char *site_pattern = reader.getArray<int32_t>(nsite);
+            aln->resize(nptn);
+            for (uint64_t ptn = 0; ptn < nptn; ptn++) {
+                Pattern &pat = aln->at(ptn);
+                int32_t value;
+                pat.resize(nseq);
+                if (nseq)
+                    memcpy(&pat[0], states + ptn*nseq*sizeof(StateType), nseq*sizeof(StateType));
+                memcpy(&value, freqs + ptn*sizeof(int32_t), sizeof(int32_t));
+                pat.frequency = value;
+                memcpy(&value, flags + ptn*sizeof(int32_t), sizeof(int32_t));
+                pat.flag = value;
+                pat.const_char = const_chars[ptn];
+                memcpy(&value, num_chars + ptn*sizeof(int32_t), sizeof(int32_t));
+                pat.num_chars = value;
+                aln->pattern_index[pat] = ptn;
+            }
+            aln->site_pattern.resize(nsite);
+            if (nsite)
+                memcpy(&aln->site_pattern[0], site_pattern, nsite*sizeof(int32_t));
+            for (uint64_t site = 0; site < nsite; site++)
+                if (aln->site_pattern[site] < 0 || aln->site_pattern[site] >= (int)nptn)
+                    throw "corrupted site pattern";
+            aln->countConstSite();
+        }
+        if (memcmp(reader.getArray<char>(8), ALN_CACHE_MAGIC, 8) != 0 || reader.pos != reader.end)
+            throw "corrupted file";
+    } catch (const char *str) {
+        for (auto it = loaded.begin(); it != loaded.end(); it++)
+            delete *it;
+        if (verbose_mode >= VB_MED)
+            cout << "Ignore alignment cache " << filename << ": " << str << endl;
+        return false;
+    } catch (string str) {
+        for (auto it = loaded.begin(); it != loaded.end(); it++)
+            delete *it;
+        if (verbose_mode >= VB_MED)
+            cout << "Ignore alignment cache " << filename << ": " << str << endl;
+        return false;
+    }
+    alns.insert(alns.end(), loaded.begin(), loaded.end());
+    cout << "Alignment restored from cache " << filename << " (" << loaded.size()
+         << ((loaded.size() == 1) ? " alignment" : " partitions") << ", "
+         << getRealTime() - start_time << " sec)" << endl;
+    // same reports and checks as after reading the alignment files
+    for (auto it = loaded.begin(); it != loaded.end(); it++)
+        (*it)->reportAlignment();
+    return true;
+}
@@ -0,0 +1,103 @@
+//
+// C++ Interface: alignmentcache
+//
+// Description: binary cache of compressed alignments for fast restarts
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#ifndef ALIGNMENTCACHE_H
+#define ALIGNMENTCACHE_H
+
+#include "alignment.h"
+
+/** magic string at the start of an alignment cache file */
+#define ALN_CACHE_MAGIC "IQALNBIN"
+
+/** version of the cache format, increase whenever the layout changes */
+const uint32_t ALN_CACHE_VERSION = 1;
+
+/**
+    Binary cache of the compressed alignment(s) of a run, written with
+    --aln-cache as PREFIX.alncache next to the checkpoint file PREFIX.ckp.gz.
+
+    The file stores, for every alignment (or every partition of a partitioned
+    analysis), the CharSet information, data type, sequence names, the
+    column-major pattern states with their frequencies and flags, and the
+    site-to-pattern map. Restarting a run memory-maps the file and copies
+    these arrays back without parsing any text.
+
+    The cache is only used if its version matches, the options affecting how
+    the alignment is read are unchanged, and every source file (alignment and
+    partition files) still has the recorded size and checksum.
+*/
+class AlignmentCache {
+public:
+
+    /**
+        @param params program parameters
+        @return TRUE if the alignment cache applies to this run
+     */
+    static bool isEnabled(Params &params);
+
+    /**
+        @param params program parameters
+        @return name of the alignment cache file of this run
+     */
+    static string getFileName(Params &params);
+
+    /**
+        restore alignments from the cache file of this run
+        @param params program parameters
+        @param[out] alns restored alignments, the caller takes ownership
+        @return TRUE if the cache exists, is up-to-date and was loaded
+     */
+    static bool load(Params &params, vector<Alignment*> &alns);
+
+    /**
+        write alignments into the cache file of this run
+        (only the MPI master writes; silently skipped for unsupported data, e.g. PoMo)
+        @param params program parameters
+        @param alns alignments to save
+        @return TRUE if the cache was written
+     */
+    static bool save(Params &params, vector<Alignment*> &alns);
+
+protected:
+
+    /** size and checksum of one source file */
+    struct SourceFile {
+        string name;
+        uint64_t size;
+        uint64_t checksum;
+    };
+
+    /**
+        compute size and checksum of a file
+        @param[in,out] src source file, name must be set
+        @return FALSE if the file cannot be read
+     */
+    static bool computeChecksum(SourceFile &src);
+
+    /**
+        collect all regular files behind a (comma-separated list of) file or directory name(s)
+        @param name file name(s)
+        @param[in,out] files file names, duplicates are ignored
+     */
+    static void addSourceFiles(const string &name, StrVector &files);
+
+    /**
+        @param params program parameters
+        @return hash of the options that affect reading the alignment
+     */
+    static uint64_t getOptionHash(Params &params);
+
+    /**
+        @param aln an alignment
+        @return FALSE if this alignment cannot be cached (PoMo, unknown genetic code)
+     */
+    static bool isSupported(Alignment *aln);
+};
+
+#endif
@@ -0,0 +1,389 @@
+//
+// C++ Implementation: mappedalignment
+//
+// Description: memory-mapped, column-block reader for FASTA and PHYLIP alignments
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#include "mappedalignment.h"
+#include "utils/progress.h"
+#include <algorithm>
+#include <sstream>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define IQTREE_HAVE_MMAP
+#endif
+
+/** release consumed pages of the index pass every that many bytes */
+const size_t RELEASE_INTERVAL = 64 << 20;
+
+MappedAlignmentFile::SequenceLayout::SequenceLayout() {
+    length = 0;
+    num_lines = 0;
+    regular = true;
+    released = 0;
+    first_offset = first_width = 0;
+    line_offset = line_width = line_stride = 0;
+}
+
+size_t MappedAlignmentFile::SequenceLayout::getOffset(size_t site) const {
+    if (site < first_width)
+        return first_offset + site;
+    site -= first_width;
+    return line_offset + (site / line_width) * line_stride + site % line_width;
+}
+
+void MappedAlignmentFile::SequenceLayout::makeIrregular() {
+    regular = false;
+    segments.reserve(num_lines+1);
+    size_t site = 0;
+    for (size_t k = 0; k < num_lines; k++) {
+        size_t offset, width;
+        if (k == 0) {
+            offset = first_offset;
+            width = first_width;
+        } else {
+            offset = line_offset + (k-1)*line_stride;
+            width = min(line_width, length - site);
+        }
+        LineSegment seg = {offset, offset+width, site};
+        segments.push_back(seg);
+        site += width;
+    }
+}
+
+void MappedAlignmentFile::SequenceLayout::addLine(size_t offset, size_t end, size_t num, bool no_blanks) {
+    if (regular) {
+        bool fits = no_blanks;
+        if (fits && num_lines == 0) {
+            first_offset = offset;
+            first_width = num;
+        } else if (fits && num_lines == 1) {
+            line_offset = offset;
+            line_width = num;
+        } else if (fits) {
+            // all lines but the last one must be full
+            fits = (length == first_width + (num_lines-1)*line_width) && num <= line_width;
+            if (fits && num_lines == 2) {
+                fits = offset > line_offset;
+                line_stride = offset - line_offset;
+            } else if (fits) {
+                fits = (offset == line_offset + (num_lines-1)*line_stride);
+            }
+        }
+        if (!fits)
+            makeIrregular();
+    }
+    if (!regular) {
+        LineSegment seg = {offset, end, length};
+        segments.push_back(seg);
+    }
+    length += num;
+    num_lines++;
+}
+
+MappedFile::MappedFile() {
+    data = NULL;
+    length = 0;
+    fd = -1;
+}
+
+MappedFile::~MappedFile() {
+    MappedFile::close();
+}
+
+bool MappedFile::open(const char *filename) {
+    close();
+#ifdef IQTREE_HAVE_MMAP
+    fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 2) {
+        close();
+        return false;
+    }
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data = (const char*)addr;
+    length = st.st_size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef IQTREE_HAVE_MMAP
+    if (data)
+        munmap((void*)data, length);
+    if (fd >= 0)
+        ::close(fd);
+#endif
+    data = NULL;
+    length = 0;
+    fd = -1;
+}
+
+void MappedFile::releasePages(size_t begin, size_t end) {
+#if defined(IQTREE_HAVE_MMAP) && defined(MADV_DONTNEED)
+    // file pages are clean: dropping them only means a re-read if touched again
+    size_t page = sysconf(_SC_PAGESIZE);
+    begin = ((begin + page - 1) / page) * page;
+    end = (end / page) * page;
+    if (begin < end)
+        madvise((void*)(data+begin), end-begin, MADV_DONTNEED);
+#endif
+}
+
+MappedAlignmentFile::MappedAlignmentFile() {
+    exclam_found = false;
+}
+
+bool MappedAlignmentFile::open(const char *filename) {
+    if (!MappedFile::open(filename))
+        return false;
+    // gzip-compressed files must go through igzstream
+    if ((unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedAlignmentFile::close() {
+    MappedFile::close();
+    layouts.clear();
+}
+
+bool MappedAlignmentFile::nextLine(size_t &pos, size_t &begin, size_t &end) {
+    if (pos >= length)
+        return false;
+    begin = pos;
+    const char *nl = (const char*)memchr(data+pos, '\n', length-pos);
+    if (nl) {
+        end = nl - data;
+        pos = end+1;
+    } else {
+        end = length;
+        pos = length;
+    }
+    while (end > begin && data[end-1] == '\r')
+        end--;
+    return true;
+}
+
+int64_t MappedAlignmentFile::scanResidues(size_t begin, size_t end, int line_num, size_t *char_count,
+                                          size_t &first, size_t &last, bool &no_blanks)
+{
+    int64_t num = 0;
+    bool blank_seen = false;
+    first = last = begin;
+    no_blanks = true;
+    for (size_t i = begin; i < end; i++) {
+        unsigned char ch = data[i];
+        if (ch <= ' ') {
+            if (num) blank_seen = true;
+            continue;
+        }
+        if (isalnum(ch) || ch == '-' || ch == '?'|| ch == '.' || ch == '*' || ch == '~' || ch == '!') {
+            if (ch == '!' && !exclam_found) {
+                exclam_found = true;
+                cout << "Warning: Line " + convertIntToString(line_num) + ": '!' was found in the alignment, which will be interpreted as a gap" << endl;
+            }
+            if (blank_seen)
+                no_blanks = false;
+            if (num == 0)
+                first = i;
+            last = i+1;
+            num++;
+            char_count[toupper(ch)]++;
+        } else if (ch == '(' || ch == '{') {
+            // bracketed ambiguity is left to the standard reader
+            return -1;
+        } else {
+            throw "Line " + convertIntToString(line_num) + ": Unrecognized character " + string(1, ch);
+        }
+    }
+    return num;
+}
+
+bool MappedAlignmentFile::indexFasta(StrVector &seq_names, size_t *char_count) {
+    size_t pos = 0, begin, end, released = 0;
+    int line_num = 0;
+    layouts.clear();
+    progress_display progress(length, "Indexing fasta file", "", "");
+    while (nextLine(pos, begin, end)) {
+        line_num++;
+        if (begin == end)
+            continue;
+        if (data[begin] == '>') { // next sequence
+            seq_names.push_back(string(data+begin+1, end-begin-1));
+            trimString(seq_names.back());
+            layouts.push_back(SequenceLayout());
+            continue;
+        }
+        // read sequence contents
+        if (layouts.empty()) {
+            throw "First line must begin with '>' to define sequence name";
+        }
+        size_t first, last;
+        bool no_blanks;
+        int64_t num = scanResidues(begin, end, line_num, char_count, first, last, no_blanks);
+        if (num < 0)
+            return false;
+        if (num > 0)
+            layouts.back().addLine(first, last, num, no_blanks);
+        if (pos - released > RELEASE_INTERVAL) {
+            releasePages(released, begin);
+            released = begin;
+            progress = (double)pos;
+        }
+    }
+    progress.done();
+    return !layouts.empty();
+}
+
+bool MappedAlignmentFile::indexPhylip(bool sequential, StrVector &seq_names, int &nsite, size_t *char_count) {
+    size_t pos = 0, begin, end, released = 0;
+    int line_num = 0, nseq = 0, seq_id = 0;
+    layouts.clear();
+    progress_display progress(length, "Indexing phylip file", "", "");
+    while (nextLine(pos, begin, end)) {
+        line_num++;
+        if (begin == end)
+            continue;
+        if (nseq == 0) { // read number of sequences and sites
+            istringstream line_in(string(data+begin, end-begin));
+            if (!(line_in >> nseq >> nsite))
+                throw "Invalid PHYLIP format. First line must contain number of sequences and sites";
+            if (nseq < 3)
+                throw "There must be at least 3 sequences";
+            if (nsite < 1)
+                throw "No alignment columns";
+            seq_names.assign(nseq, "");
+            layouts.assign(nseq, SequenceLayout());
+            continue;
+        }
+        if (seq_id >= nseq)
+            throw "Line " + convertIntToString(line_num) + ": Too many sequences detected";
+        if (seq_names[seq_id] == "") { // cut out the sequence name
+            size_t name_end = begin;
+            while (name_end < end && data[name_end] != ' ' && data[name_end] != '\t')
+                name_end++;
+            if (name_end == end) //  assume standard phylip
+                name_end = min(begin+10, end);
+            seq_names[seq_id] = string(data+begin, name_end-begin);
+            begin = name_end;
+        }
+        size_t first, last;
+        bool no_blanks;
+        int64_t num = scanResidues(begin, end, line_num, char_count, first, last, no_blanks);
+        if (num < 0)
+            return false;
+        SequenceLayout &layout = layouts[seq_id];
+        if (num > 0)
+            layout.addLine(first, last, num, no_blanks);
+        if (sequential) {
+            if (layout.length > nsite)
+                throw ("Line " + convertIntToString(line_num) + ": Sequence " + seq_names[seq_id] + " is too long (" + convertIntToString(layout.length) + ")");
+            if (layout.length == nsite)
+                seq_id++;
+        } else {
+            if (layout.length != layouts[0].length) {
+                ostringstream err_str;
+                err_str << "Line " << line_num << ": Sequence " << seq_names[seq_id] << " has wrong sequence length " << layout.length << endl;
+                throw err_str.str();
+            }
+            if (num > 0)
+                seq_id++;
+            if (seq_id == nseq)
+                seq_id = 0;
+        }
+        if (pos - released > RELEASE_INTERVAL) {
+            releasePages(released, begin);
+            released = begin;
+            progress = (double)pos;
+        }
+    }
+    progress.done();
+    return nseq > 0;
+}
+
+void MappedAlignmentFile::readBlock(size_t first_site, size_t nsite, StrVector &block) {
+    size_t nseq = layouts.size();
+    block.resize(nseq);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (size_t seq = 0; seq < nseq; seq++) {
+        SequenceLayout &layout = layouts[seq];
+        ASSERT(first_site + nsite <= layout.length);
+        block[seq].resize(nsite);
+        char *out = &block[seq][0];
+        size_t stop = first_site + nsite;
+        if (layout.regular) {
+            // copy line by line
+            for (size_t site = first_site; site < stop; ) {
+                const char *in = data + layout.getOffset(site);
+                size_t run;
+                if (site < layout.first_width)
+                    run = layout.first_width - site;
+                else
+                    run = layout.line_width - (site - layout.first_width) % layout.line_width;
+                run = min(run, stop - site);
+                for (size_t i = 0; i < run; i++)
+                    out[i] = toupper(in[i]);
+                out += run;
+                site += run;
+            }
+        } else {
+            // locate the line containing first_site, then skip blanks while copying
+            vector<LineSegment>::iterator seg = layout.segments.begin();
+            size_t lo = 0, hi = layout.segments.size();
+            while (hi - lo > 1) {
+                size_t mid = (lo + hi) / 2;
+                if (layout.segments[mid].first_site <= first_site)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            seg += lo;
+            size_t site = seg->first_site;
+            size_t pos = seg->offset;
+            while (site < stop) {
+                if (pos >= seg->end) {
+                    ++seg;
+                    pos = seg->offset;
+                    continue;
+                }
+                unsigned char ch = data[pos++];
+                if (ch <= ' ')
+                    continue;
+                if (site >= first_site)
+                    *out++ = toupper(ch);
+                site++;
+            }
+        }
+    }
+    // pages before this block are not needed any more
+    for (size_t seq = 0; seq < nseq; seq++) {
+        SequenceLayout &layout = layouts[seq];
+        if (!layout.regular || first_site == 0)
+            continue;
+        size_t offset = layout.getOffset(first_site);
+        if (offset > layout.released + RELEASE_INTERVAL/nseq) {
+            releasePages(max(layout.released, layout.first_offset), offset);
+            layout.released = offset;
+        }
+    }
+}
@@ -0,0 +1,178 @@
+//
+// C++ Interface: mappedalignment
+//
+// Description: memory-mapped, column-block reader for FASTA and PHYLIP alignments
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#ifndef MAPPEDALIGNMENT_H
+#define MAPPEDALIGNMENT_H
+
+#include "utils/tools.h"
+
+/**
+    Read-only memory-mapped file
+*/
+class MappedFile {
+public:
+
+    MappedFile();
+
+    virtual ~MappedFile();
+
+    /**
+        memory-map a file
+        @param filename file name
+        @return FALSE if the file cannot be mapped (e.g. missing, empty or unsupported OS)
+     */
+    virtual bool open(const char *filename);
+
+    /** unmap the file */
+    virtual void close();
+
+    /** @return mapped file content */
+    const char *getData() const {
+        return data;
+    }
+
+    /** @return size of the mapped file in bytes */
+    size_t getLength() const {
+        return length;
+    }
+
+protected:
+
+    /** give back to the OS the mapped pages fully inside [begin, end) (no-op if unsupported) */
+    void releasePages(size_t begin, size_t end);
+
+    /** mapped file content */
+    const char *data;
+
+    /** file size in bytes */
+    size_t length;
+
+    /** file descriptor of the mapped file */
+    int fd;
+};
+
+/**
+    Memory-mapped FASTA/PHYLIP alignment file.
+    indexFasta()/indexPhylip() scan the file once and record, for every sequence,
+    where its residues are located in the file, without copying them.
+    readBlock() then extracts a block of alignment columns for all sequences,
+    so that patterns can be built block by block and the sequences are never
+    held in memory in full.
+*/
+class MappedAlignmentFile : public MappedFile {
+public:
+
+    MappedAlignmentFile();
+
+    /**
+        memory-map a file
+        @param filename file name
+        @return FALSE if the file cannot be mapped (e.g. gzip-compressed, empty or unsupported OS)
+     */
+    virtual bool open(const char *filename);
+
+    /** unmap the file and clear the index */
+    virtual void close();
+
+    /**
+        index an alignment in FASTA format
+        @param[out] seq_names sequence names (not shortened)
+        @param[out] char_count number of occurrences of each (upper-case) character
+        @return FALSE if the file uses features not supported by the streaming reader
+     */
+    bool indexFasta(StrVector &seq_names, size_t *char_count);
+
+    /**
+        index an alignment in PHYLIP format
+        @param sequential TRUE for sequential, FALSE for interleaved PHYLIP
+        @param[out] seq_names sequence names
+        @param[out] nsite number of sites given in the PHYLIP header
+        @param[out] char_count number of occurrences of each (upper-case) character
+        @return FALSE if the file uses features not supported by the streaming reader
+     */
+    bool indexPhylip(bool sequential, StrVector &seq_names, int &nsite, size_t *char_count);
+
+    /**
+        @param seq sequence ID
+        @return number of residues of sequence seq
+     */
+    size_t getSeqLength(int seq) const {
+        return layouts[seq].length;
+    }
+
+    /**
+        extract alignment columns [first_site, first_site+nsite) of all sequences
+        @param first_site first column
+        @param nsite number of columns (first_site+nsite must not exceed any sequence length)
+        @param[out] block nseq strings of nsite upper-case characters each
+     */
+    void readBlock(size_t first_site, size_t nsite, StrVector &block);
+
+protected:
+
+    /** raw byte range of one line of residues; may contain blanks */
+    struct LineSegment {
+        size_t offset;
+        size_t end;
+        size_t first_site;
+    };
+
+    /**
+        location of the residues of one sequence in the file.
+        Regular sequences have all lines but the first evenly spaced with the same
+        number of residues and no blanks, so any site is found in O(1) without
+        per-line storage. Others keep one LineSegment per line.
+     */
+    struct SequenceLayout {
+        SequenceLayout();
+
+        /** @return file offset of residue site of a regular sequence */
+        size_t getOffset(size_t site) const;
+
+        /** add one line of residues [offset, end), found to contain num residues */
+        void addLine(size_t offset, size_t end, size_t num, bool no_blanks);
+
+        /** switch to one LineSegment per line */
+        void makeIrregular();
+
+        size_t length;
+        size_t num_lines;
+        bool regular;
+        /** offset before which pages of this sequence have been released */
+        size_t released;
+        size_t first_offset, first_width;
+        size_t line_offset, line_width, line_stride;
+        vector<LineSegment> segments;
+    };
+
+    /**
+        scan residues in [begin, end) of line line_num
+        @param[out] first, last offsets of the first and one past the last residue
+        @param[out] no_blanks TRUE if there is no blank between the first and last residue
+        @return number of residues, or -1 if the line needs the standard reader
+     */
+    int64_t scanResidues(size_t begin, size_t end, int line_num, size_t *char_count,
+                         size_t &first, size_t &last, bool &no_blanks);
+
+    /**
+        get the next line
+        @param[in,out] pos offset where the line starts, moved to the start of the next line
+        @param[out] begin, end offsets of the line, excluding line break characters
+        @return FALSE at end of file
+     */
+    bool nextLine(size_t &pos, size_t &begin, size_t &end);
+
+    /** TRUE if '!' was found (and a warning printed) */
+    bool exclam_found;
+
+    /** residue locations per sequence */
+    vector<SequenceLayout> layouts;
+};
+
+#endif
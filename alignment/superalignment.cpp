@@ -20,6 +20,7 @@
 
 #include <stdarg.h>
 #include "superalignment.h"
+#include "alignmentcache.h"
 #include "nclextra/msetsblock.h"
 #include "nclextra/myreader.h"
 #include "main/phylotesting.h"
@@ -70,21 +71,25 @@ SuperAlignment::SuperAlignment(Params &params) : Alignment()
 }
 
 void SuperAlignment::readFromParams(Params &params) {
-    if (isDirectory(params.partition_file)) {
-        // reading all files in the directory
-        readPartitionDir(params.partition_file, params.sequence_type, params.intype, params.model_name, params.remove_empty_seq);
-    } else if (strstr(params.partition_file, ",") != nullptr) {
-        // reading all files in a comma-separated list
-        readPartitionList(params.partition_file, params.sequence_type, params.intype, params.model_name, params.remove_empty_seq);
-    } else {
-        cout << "Reading partition model file " << params.partition_file << " ..." << endl;
-        if (detectInputFile(params.partition_file) == IN_NEXUS) {
-            readPartitionNexus(params);
-            if (partitions.empty()) {
-                outError("No partition found in SETS block. An example syntax looks like: \n#nexus\nbegin sets;\n  charset part1=1-100;\n  charset part2=101-300;\nend;");
-            }
-        } else
-            readPartitionRaxml(params);
+    // restore partitions from the binary alignment cache if it is up-to-date
+    bool cached = AlignmentCache::load(params, partitions);
+    if (!cached) {
+        if (isDirectory(params.partition_file)) {
+            // reading all files in the directory
+            readPartitionDir(params.partition_file, params.sequence_type, params.intype, params.model_name, params.remove_empty_seq);
+        } else if (strstr(params.partition_file, ",") != nullptr) {
+            // reading all files in a comma-separated list
+            readPartitionList(params.partition_file, params.sequence_type, params.intype, params.model_name, params.remove_empty_seq);
+        } else {
+            cout << "Reading partition model file " << params.partition_file << " ..." << endl;
+            if (detectInputFile(params.partition_file) == IN_NEXUS) {
+                readPartitionNexus(params);
+                if (partitions.empty()) {
+                    outError("No partition found in SETS block. An example syntax looks like: \n#nexus\nbegin sets;\n  charset part1=1-100;\n  charset part2=101-300;\nend;");
+                }
+            } else
+                readPartitionRaxml(params);
+        }
     }
     if (partitions.empty())
         outError("No partition found");
@@ -96,6 +101,9 @@ void SuperAlignment::readFromParams(Params &params) {
             outError("Duplicated partition name ", (*pit)->name);
         part_names.insert((*pit)->name);
     }
+
+    if (!cached)
+        AlignmentCache::save(params, partitions);
     
     if (params.subsampling != 0) {
         // sumsample a number of partitions
@@ -2249,10 +2249,13 @@ int main(int argc, char *argv[]) {
     Checkpoint *checkpoint = new Checkpoint;
     string filename = (string)Params::getInstance().out_prefix +".ckp.gz";
     checkpoint->setFileName(filename);
+    if (Params::getInstance().checkpoint_binary)
+        checkpoint->setBinary(true);
     
     bool append_log = false;
     
-    if (!Params::getInstance().ignore_checkpoint && fileExists(filename)) {
+    if (!Params::getInstance().ignore_checkpoint &&
+        (fileExists(filename) || (Params::getInstance().checkpoint_binary && fileExists(checkpoint->getBinaryFileName())))) {
         checkpoint->load();
         if (checkpoint->hasKey("finished")) {
             if (checkpoint->getBool("finished")) {
@@ -32,6 +32,7 @@
 #include "alignment/alignment.h"
 #include "alignment/superalignment.h"
 #include "alignment/superalignmentunlinked.h"
+#include "alignment/alignmentcache.h"
 #include "tree/iqtree.h"
 #include "tree/iqtreemix.h"
 #include "tree/phylotreemixlen.h"
@@ -2982,7 +2983,9 @@ void runTreeReconstruction(Params &params, IQTree* &iqtree) {
         cout << "Computing rootstrap supports..." << endl;
         string saved = iqtree->getTreeString();
         MTreeSet trees;
-        trees.init(iqtree->boot_trees, iqtree->rooted);
+        StrVector boot_trees;
+        iqtree->boot_trees.getTrees(boot_trees);
+        trees.init(boot_trees, iqtree->rooted);
         iqtree->computeRootstrap(trees, true);
         iqtree->readTreeString(saved);
     }
@@ -3422,6 +3425,424 @@ void exhaustiveSearchGAMMAInvar(Params &params, IQTree &iqtree) {
 /**********************************************************
  * STANDARD NON-PARAMETRIC BOOTSTRAP
  ***********************************************************/
+
+/**
+    resample the alignment of one bootstrap replicate with the current random stream
+    @param params program parameters
+    @param alignment original alignment
+    @return bootstrap alignment
+*/
+Alignment *newBootstrapAlignment(Params &params, Alignment *alignment) {
+    Alignment *bootstrap_alignment;
+    if (alignment->isSuperAlignment())
+        bootstrap_alignment = new SuperAlignment;
+    else
+        bootstrap_alignment = new Alignment;
+    bootstrap_alignment->createBootstrapAlignment(alignment, NULL, params.bootstrap_spec);
+    return bootstrap_alignment;
+}
+
+/**
+    write the outputs of a bootstrap alignment requested by the print options
+    (.bootlh, .bootaln, .bootsitefreq)
+    @param params program parameters
+    @param alignment original alignment
+    @param bootstrap_alignment bootstrap alignment of replicate sample
+    @param sample replicate index
+*/
+void printBootstrapAlignment(Params &params, Alignment *alignment, Alignment *bootstrap_alignment, int sample) {
+    if (!MPIHelper::getInstance().isMaster())
+        return;
+    if (params.print_tree_lh) {
+        string bootlh_name = (string)params.out_prefix + ".bootlh";
+        double prob;
+        bootstrap_alignment->multinomialProb(*alignment, prob);
+        ofstream boot_lh;
+        if (sample == 0)
+            boot_lh.open(bootlh_name.c_str());
+        else
+            boot_lh.open(bootlh_name.c_str(), ios_base::out | ios_base::app);
+        boot_lh << "0\t" << prob << endl;
+        boot_lh.close();
+    }
+    if (params.print_bootaln) {
+        string bootaln_name = (string)params.out_prefix + ".bootaln";
+        bootstrap_alignment->printAlignment(params.aln_output_format, bootaln_name.c_str(), true);
+    }
+    if (params.print_boot_site_freq) {
+        printSiteStateFreq((((string)params.out_prefix)+"."+convertIntToString(sample)+".bootsitefreq").c_str(), bootstrap_alignment);
+            bootstrap_alignment->printAlignment(params.aln_output_format, (((string)params.out_prefix)+"."+convertIntToString(sample)+".bootaln").c_str());
+    }
+}
+
+/**
+    allocate the tree of a bootstrap replicate, of the same kind as the tree of the original alignment
+    @param params program parameters
+    @param alignment original alignment
+    @param tree tree of the original alignment
+    @param bootstrap_alignment bootstrap alignment
+    @return new tree for bootstrap_alignment
+*/
+IQTree *newBootstrapTree(Params &params, Alignment *alignment, IQTree *tree, Alignment *bootstrap_alignment) {
+    IQTree *boot_tree;
+    if (alignment->isSuperAlignment()){
+        if(params.partition_type != BRLEN_OPTIMIZE){
+            boot_tree = new PhyloSuperTreePlen((SuperAlignment*) bootstrap_alignment, (PhyloSuperTree*) tree);
+        } else {
+            boot_tree = new PhyloSuperTree((SuperAlignment*) bootstrap_alignment, (PhyloSuperTree*) tree);
+        }
+    } else {
+        // allocate heterotachy tree if neccessary
+        int pos = posRateHeterotachy(alignment->model_name);
+
+        if (params.num_mixlen > 1) {
+            boot_tree = new PhyloTreeMixlen(bootstrap_alignment, params.num_mixlen);
+        } else if (pos != string::npos) {
+            boot_tree = new PhyloTreeMixlen(bootstrap_alignment, 0);
+        } else
+            boot_tree = new IQTree(bootstrap_alignment);
+    }
+    if (!tree->constraintTree.empty()) {
+        boot_tree->constraintTree.readConstraint(tree->constraintTree);
+    }
+    boot_tree->num_precision = tree->num_precision;
+    return boot_tree;
+}
+
+/**
+    @param sample replicate index
+    @return checkpoint key of the tree of a finished replicate not yet written to .boottrees
+*/
+string bootTreeKey(int sample) {
+    return "bootTree" + convertIntToString(sample);
+}
+
+/**
+    run the tree search of one replicate as an independent job (--boot-parallel).
+    The replicate draws all random numbers from its own stream seeded by the
+    replicate index, so its tree does not depend on which process runs it or
+    in which order. It writes its checkpoint and temporary files under the
+    prefix PREFIX.bootNUM, so that an interrupted replicate resumes from its
+    own checkpoint. These files are removed once the replicate is finished.
+    @param params program parameters
+    @param alignment original alignment
+    @param tree tree of the original alignment
+    @param sample replicate index
+    @return the bootstrap tree
+*/
+string runBootstrapReplicate(Params &params, Alignment *alignment, IQTree *tree, int sample) {
+    string rep_prefix = (string)params.out_prefix + ".boot" + convertIntToString(sample+1);
+    char *saved_out_prefix = params.out_prefix;
+    params.out_prefix = (char*)rep_prefix.c_str();
+
+#ifdef _IQTREE_MPI
+    // an MPI worker searches the replicate alone, as if it were a single process
+    MPIHelper &mpi = MPIHelper::getInstance();
+    int saved_process_id = mpi.getProcessID();
+    int saved_num_processes = mpi.getNumProcesses();
+    int saved_output_flags = params.suppress_output_flags;
+    VerboseMode saved_verbose_mode = verbose_mode;
+    if (saved_num_processes > 1) {
+        // workers have no log file
+        params.suppress_output_flags |= OUT_LOG;
+        verbose_mode = VB_QUIET;
+        mpi.setProcessID(PROC_MASTER);
+        mpi.setNumProcesses(1);
+    }
+#endif
+
+    Checkpoint *checkpoint = new Checkpoint;
+    checkpoint->setFileName(rep_prefix + ".ckp.gz");
+    checkpoint->setDumpInterval(params.checkpoint_dump_interval);
+    if (params.checkpoint_binary)
+        checkpoint->setBinary(true);
+    if (!params.ignore_checkpoint && (fileExists(checkpoint->getFileName()) ||
+        (params.checkpoint_binary && fileExists(checkpoint->getBinaryFileName()))))
+    {
+        if (checkpoint->load())
+            cout << "CHECKPOINT: Resuming " << RESAMPLE_NAME << " replicate " << sample+1
+                 << " from " << checkpoint->getFileName() << endl;
+    }
+
+    int *saved_randstream = randstream;
+    init_random(params.ran_seed + sample);
+    cout << "Creating " << RESAMPLE_NAME << " alignment (seed: " << params.ran_seed+sample << ")..." << endl;
+    Alignment *bootstrap_alignment = newBootstrapAlignment(params, alignment);
+    IQTree *boot_tree = newBootstrapTree(params, alignment, tree, bootstrap_alignment);
+    boot_tree->setCheckpoint(checkpoint);
+
+    runTreeReconstruction(params, boot_tree);
+    stringstream ss;
+    boot_tree->printTree(ss);
+
+    bootstrap_alignment = boot_tree->aln;
+    delete boot_tree;
+    delete bootstrap_alignment;
+    finish_random();
+    randstream = saved_randstream;
+
+    string binary_file = checkpoint->getBinaryFileName();
+    delete checkpoint;
+    const char *suffixes[] = {".ckp.gz", ".bionj", ".mldist", ".obsdist", ".treefile", ".uniqueseq.phy"};
+    for (size_t i = 0; i < sizeof(suffixes)/sizeof(suffixes[0]); i++)
+        if (fileExists(rep_prefix + suffixes[i]))
+            std::remove((rep_prefix + suffixes[i]).c_str());
+    if (fileExists(binary_file))
+        std::remove(binary_file.c_str());
+
+#ifdef _IQTREE_MPI
+    if (saved_num_processes > 1) {
+        mpi.setProcessID(saved_process_id);
+        mpi.setNumProcesses(saved_num_processes);
+        params.suppress_output_flags = saved_output_flags;
+        verbose_mode = saved_verbose_mode;
+    }
+#endif
+    params.out_prefix = saved_out_prefix;
+    return ss.str();
+}
+
+/**
+    record the tree of a finished replicate in the checkpoint, then append the
+    trees of all consecutive finished replicates to the .boottrees file, so that
+    the file lists the trees in replicate order whatever order they finish in
+    @param params program parameters
+    @param alignment original alignment
+    @param checkpoint main checkpoint
+    @param sample replicate index
+    @param tree_str bootstrap tree of replicate sample
+    @param[in,out] next_sample first replicate not yet written to .boottrees
+*/
+void collectBootstrapTree(Params &params, Alignment *alignment, Checkpoint *checkpoint,
+                          int sample, string &tree_str, int &next_sample)
+{
+    checkpoint->put(bootTreeKey(sample), tree_str);
+    string boottrees_name = (string)params.out_prefix + ".boottrees";
+    string next_tree;
+    while (checkpoint->getString(bootTreeKey(next_sample), next_tree)) {
+        try {
+            ofstream tree_out;
+            tree_out.exceptions(ios::failbit | ios::badbit);
+            tree_out.open(boottrees_name.c_str(), ios_base::out | ios_base::app);
+            tree_out << next_tree << endl;
+            tree_out.close();
+        } catch (ios::failure) {
+            outError(ERR_WRITE_OUTPUT, boottrees_name);
+        }
+        if (params.print_tree_lh || params.print_bootaln || params.print_boot_site_freq) {
+            // the replicate alignment is cheap to redraw from its seed
+            int *saved_randstream = randstream;
+            init_random(params.ran_seed + next_sample);
+            Alignment *bootstrap_alignment = newBootstrapAlignment(params, alignment);
+            finish_random();
+            randstream = saved_randstream;
+            printBootstrapAlignment(params, alignment, bootstrap_alignment, next_sample);
+            delete bootstrap_alignment;
+        }
+        checkpoint->erase(bootTreeKey(next_sample));
+        next_sample++;
+    }
+    checkpoint->put("bootSample", next_sample);
+    checkpoint->putBool("finished", false);
+    checkpoint->dump(true);
+}
+
+/**
+    run the bootstrap replicates from boot_sample on as independent jobs (--boot-parallel).
+    With MPI, the master hands out replicates to the workers, which run them
+    concurrently, and collects their trees; otherwise the replicates run one
+    after another. Finished replicates are kept in the checkpoint, so that a
+    resumed run only reruns the unfinished ones.
+    @param params program parameters
+    @param alignment original alignment
+    @param tree tree of the original alignment
+    @param boot_sample number of replicates already written to .boottrees
+*/
+void runParallelBootstrap(Params &params, Alignment *alignment, IQTree *tree, int boot_sample) {
+    Checkpoint *checkpoint = tree->getCheckpoint();
+    int num_samples = params.num_bootstrap_samples;
+    int sample;
+
+    // keep only the general information and the finished replicates
+    StrVector finished_trees(num_samples);
+    int num_finished = 0;
+    for (sample = boot_sample; sample < num_samples; sample++)
+        if (checkpoint->getString(bootTreeKey(sample), finished_trees[sample]))
+            num_finished++;
+    checkpoint->keepKeyPrefix("iqtree");
+    for (sample = boot_sample; sample < num_samples; sample++)
+        if (!finished_trees[sample].empty())
+            checkpoint->put(bootTreeKey(sample), finished_trees[sample]);
+    checkpoint->put("bootSample", boot_sample);
+    checkpoint->putBool("finished", false);
+    if (num_finished > 0)
+        cout << "CHECKPOINT: " << num_finished << " more " << RESAMPLE_NAME << " replicates restored" << endl;
+
+    int next_sample = boot_sample;
+
+#ifdef _IQTREE_MPI
+    MPIHelper &mpi = MPIHelper::getInstance();
+    if (mpi.getNumProcesses() > 1) {
+        if (mpi.isMaster()) {
+            cout << endl << "===> RUN " << num_samples - boot_sample - num_finished << " " << RESAMPLE_NAME_UPPER
+                 << " REPLICATES ON " << mpi.getNumProcesses()-1 << " MPI WORKERS" << endl << endl;
+            int num_workers = mpi.getNumProcesses()-1;
+            sample = boot_sample;
+            while (num_workers > 0) {
+                string msg;
+                int worker = mpi.recvString(msg, MPI_ANY_SOURCE, BOOT_RESULT_TAG);
+                if (!msg.empty()) {
+                    // tree of the previous replicate of this worker
+                    stringstream in(msg);
+                    int done_sample;
+                    string tree_str;
+                    in >> done_sample;
+                    in >> tree_str;
+                    collectBootstrapTree(params, alignment, checkpoint, done_sample, tree_str, next_sample);
+                    cout << RESAMPLE_NAME_UPPER << " replicate " << done_sample+1 << " finished by process "
+                         << worker << ", " << next_sample << " trees written" << endl;
+                }
+                while (sample < num_samples && checkpoint->hasKey(bootTreeKey(sample)))
+                    sample++;
+                int job = -1;
+                if (sample < num_samples)
+                    job = sample++;
+                else
+                    num_workers--;
+                string reply = convertIntToString(job);
+                mpi.sendString(reply, worker, BOOT_JOB_TAG);
+            }
+        } else {
+            string msg;
+            while (true) {
+                mpi.sendString(msg, PROC_MASTER, BOOT_RESULT_TAG);
+                string reply;
+                mpi.recvString(reply, PROC_MASTER, BOOT_JOB_TAG);
+                int job = convert_int(reply.c_str());
+                if (job < 0)
+                    break;
+                string tree_str = runBootstrapReplicate(params, alignment, tree, job);
+                msg = convertIntToString(job) + " " + tree_str;
+            }
+        }
+        mpi.barrier();
+        return;
+    }
+#endif
+
+    for (sample = boot_sample; sample < num_samples; sample++) {
+        if (checkpoint->hasKey(bootTreeKey(sample)))
+            continue;
+        cout << endl << "===> START " << RESAMPLE_NAME_UPPER << " REPLICATE NUMBER "
+                << sample + 1 << endl << endl;
+        string tree_str = runBootstrapReplicate(params, alignment, tree, sample);
+        collectBootstrapTree(params, alignment, checkpoint, sample, tree_str, next_sample);
+    }
+}
+
+/**
+    @param tree ML tree of the original alignment with its optimized model
+    @return TRUE if the replicates can be warm-started from tree (--boot-warm)
+*/
+bool canWarmStartBootstrap(IQTree *tree) {
+    if (tree->isSuperTree() || tree->isMixlen())
+        return false;
+    if (tree->getModel()->isSiteSpecificModel())
+        return false;
+    return tree->getModelFactory()->getASC() == ASC_NONE;
+}
+
+/**
+    run the bootstrap replicates from boot_sample on, started from the ML tree
+    and the ML model parameters of the original alignment (--boot-warm).
+    The replicates share one tree, which uses the model of the ML tree without
+    re-estimating it, and whose partial likelihood buffers are allocated once
+    for the original alignment: a bootstrap alignment has no more patterns.
+    Each replicate then runs IQTree::doWarmBootTreeSearch() instead of a full
+    tree reconstruction. Replicate alignments are drawn from the same seeds as
+    for independent replicates.
+    @param params program parameters
+    @param alignment original alignment
+    @param tree ML tree of the original alignment with its optimized model
+    @param boot_sample number of replicates already written to .boottrees
+*/
+void runWarmBootstrap(Params &params, Alignment *alignment, IQTree *tree, int boot_sample) {
+    Checkpoint *checkpoint = tree->getCheckpoint();
+    string boottrees_name = (string)params.out_prefix + ".boottrees";
+
+    IQTree *boot_tree = new IQTree(alignment);
+    // the search state of replicates is not checkpointed
+    Checkpoint *boot_checkpoint = new Checkpoint;
+    boot_tree->setCheckpoint(boot_checkpoint);
+    boot_tree->setParams(&params);
+    if (!tree->constraintTree.empty()) {
+        boot_tree->constraintTree.readConstraint(tree->constraintTree);
+    }
+    boot_tree->num_precision = tree->num_precision;
+    boot_tree->rooted = tree->rooted;
+
+    // start tree without the branch supports of the original alignment
+    boot_tree->readTreeString(tree->getTreeString());
+    NodeVector inner_nodes;
+    boot_tree->getInternalNodes(inner_nodes);
+    for (NodeVector::iterator it = inner_nodes.begin(); it != inner_nodes.end(); it++)
+        (*it)->name = "";
+    string ml_tree = boot_tree->getTreeString();
+
+    boot_tree->setNumThreads(tree->num_threads);
+    boot_tree->initSettings(params);
+    boot_tree->setModelFactory(tree->getModelFactory());
+    boot_tree->setLikelihoodKernel(tree->sse);
+    boot_tree->initializeAllPartialLh();
+
+    cout << endl << "===> START " << params.num_bootstrap_samples - boot_sample << " " << RESAMPLE_NAME_UPPER
+         << " REPLICATES FROM THE ML TREE" << endl << endl;
+    double start_real_time = getRealTime();
+    for (int sample = boot_sample; sample < params.num_bootstrap_samples; sample++) {
+        double sample_time = getRealTime();
+        int *saved_randstream = randstream;
+        init_random(params.ran_seed + sample);
+        Alignment *bootstrap_alignment = newBootstrapAlignment(params, alignment);
+        printBootstrapAlignment(params, alignment, bootstrap_alignment, sample);
+
+        boot_tree->setAlignment(bootstrap_alignment);
+        double score = boot_tree->doWarmBootTreeSearch(ml_tree, params.bootstrap_warm_unsuccess);
+        finish_random();
+        randstream = saved_randstream;
+
+        stringstream ss;
+        boot_tree->printTree(ss);
+        boot_tree->setAlignment(alignment);
+        delete bootstrap_alignment;
+
+        if (MPIHelper::getInstance().isMaster())
+        try {
+            ofstream tree_out;
+            tree_out.exceptions(ios::failbit | ios::badbit);
+            tree_out.open(boottrees_name.c_str(), ios_base::out | ios_base::app);
+            tree_out << ss.str() << endl;
+            tree_out.close();
+        } catch (ios::failure) {
+            outError(ERR_WRITE_OUTPUT, boottrees_name);
+        }
+        cout << RESAMPLE_NAME_I << " replicate " << sample+1 << ": log-likelihood " << score
+             << ", wall-clock time " << getRealTime() - sample_time << " seconds" << endl;
+
+        checkpoint->put("bootSample", sample+1);
+        checkpoint->putBool("finished", false);
+        checkpoint->dump(true);
+    }
+    if (boot_sample < params.num_bootstrap_samples)
+        cout << "Average wall-clock time per " << RESAMPLE_NAME << " replicate: "
+             << (getRealTime() - start_real_time) / (params.num_bootstrap_samples - boot_sample)
+             << " seconds" << endl;
+
+    // the model belongs to the ML tree
+    boot_tree->setModelFactory(NULL);
+    delete boot_tree;
+    delete boot_checkpoint;
+}
+
 void runStandardBootstrap(Params &params, Alignment *alignment, IQTree *tree) {
     ModelCheckpoint *model_info = new ModelCheckpoint;
     StrVector removed_seqs, twin_seqs;
@@ -3444,8 +3865,6 @@ void runStandardBootstrap(Params &params, Alignment *alignment, IQTree *tree) {
     boottrees_name += ".boottrees";
     string bootaln_name = params.out_prefix;
     bootaln_name += ".bootaln";
-    string bootlh_name = params.out_prefix;
-    bootlh_name += ".bootlh";
     int bootSample = 0;
     if (tree->getCheckpoint()->get("bootSample", bootSample)) {
         cout << "CHECKPOINT: " << bootSample << " bootstrap analyses restored" << endl;
@@ -3480,7 +3899,36 @@ void runStandardBootstrap(Params &params, Alignment *alignment, IQTree *tree) {
     // 2018-06-21: bug fix: alignment might be changed by -m ...MERGE
     alignment = tree->aln;
     
+    // --boot-warm: analyze the original alignment first to start the replicates from its ML tree
+    bool ml_tree_done = false;
+    if (params.bootstrap_warm_start) {
+        if (!params.compute_ml_tree || params.num_runs > 1 || params.bootstrap_parallel) {
+            outWarning("--boot-warm needs -b without --runs and --boot-parallel, replicates are run independently");
+        } else {
+            cout << endl << "===> START ANALYSIS ON THE ORIGINAL ALIGNMENT" << endl << endl;
+            params.aLRT_replicates = saved_aLRT_replicates;
+            params.localbp_replicates = saved_localbp_replicates;
+            params.aLRT_test = saved_aLRT_test;
+            params.aBayes_test = saved_aBayes_test;
+            runTreeReconstruction(params, tree);
+            params.aLRT_replicates = 0;
+            params.localbp_replicates = 0;
+            params.aLRT_test = false;
+            params.aBayes_test = false;
+            ml_tree_done = true;
+            alignment = tree->aln;
+            if (!canWarmStartBootstrap(tree))
+                outWarning("--boot-warm does not support partition, heterotachy, site-specific or +ASC models, replicates are run independently");
+        }
+    }
+
     // do bootstrap analysis
+    if (ml_tree_done && canWarmStartBootstrap(tree)) {
+        if (MPIHelper::getInstance().isMaster())
+            runWarmBootstrap(params, alignment, tree, bootSample);
+    } else if (params.bootstrap_parallel && params.num_bootstrap_samples > 1)
+        runParallelBootstrap(params, alignment, tree, bootSample);
+    else
     for (int sample = bootSample; sample < params.num_bootstrap_samples; sample++) {
         cout << endl << "===> START " << RESAMPLE_NAME_UPPER << " REPLICATE NUMBER "
                 << sample + 1 << endl << endl;
@@ -3490,64 +3938,18 @@ void runStandardBootstrap(Params &params, Alignment *alignment, IQTree *tree) {
         int *saved_randstream = randstream;
         init_random(params.ran_seed + sample);
 
-        Alignment* bootstrap_alignment;
         cout << "Creating " << RESAMPLE_NAME << " alignment (seed: " << params.ran_seed+sample << ")..." << endl;
-
-        if (alignment->isSuperAlignment())
-            bootstrap_alignment = new SuperAlignment;
-        else
-            bootstrap_alignment = new Alignment;
-        bootstrap_alignment->createBootstrapAlignment(alignment, NULL, params.bootstrap_spec);
+        Alignment* bootstrap_alignment = newBootstrapAlignment(params, alignment);
 
         // restore randstream
         finish_random();
         randstream = saved_randstream;
 
-        if (params.print_tree_lh && MPIHelper::getInstance().isMaster()) {
-            double prob;
-            bootstrap_alignment->multinomialProb(*alignment, prob);
-            ofstream boot_lh;
-            if (sample == 0)
-                boot_lh.open(bootlh_name.c_str());
-            else
-                boot_lh.open(bootlh_name.c_str(), ios_base::out | ios_base::app);
-            boot_lh << "0\t" << prob << endl;
-            boot_lh.close();
-        }
-        IQTree *boot_tree;
-        if (alignment->isSuperAlignment()){
-            if(params.partition_type != BRLEN_OPTIMIZE){
-                boot_tree = new PhyloSuperTreePlen((SuperAlignment*) bootstrap_alignment, (PhyloSuperTree*) tree);
-            } else {
-                boot_tree = new PhyloSuperTree((SuperAlignment*) bootstrap_alignment, (PhyloSuperTree*) tree);
-            }
-        } else {
-            // allocate heterotachy tree if neccessary
-            int pos = posRateHeterotachy(alignment->model_name);
-            
-            if (params.num_mixlen > 1) {
-                boot_tree = new PhyloTreeMixlen(bootstrap_alignment, params.num_mixlen);
-            } else if (pos != string::npos) {
-                boot_tree = new PhyloTreeMixlen(bootstrap_alignment, 0);
-            } else
-                boot_tree = new IQTree(bootstrap_alignment);
-        }
-        if (params.print_bootaln && MPIHelper::getInstance().isMaster()) {
-            bootstrap_alignment->printAlignment(params.aln_output_format, bootaln_name.c_str(), true);
-        }
-
-        if (params.print_boot_site_freq && MPIHelper::getInstance().isMaster()) {
-            printSiteStateFreq((((string)params.out_prefix)+"."+convertIntToString(sample)+".bootsitefreq").c_str(), bootstrap_alignment);
-                bootstrap_alignment->printAlignment(params.aln_output_format, (((string)params.out_prefix)+"."+convertIntToString(sample)+".bootaln").c_str());
-        }
-
-        if (!tree->constraintTree.empty()) {
-            boot_tree->constraintTree.readConstraint(tree->constraintTree);
-        }
+        printBootstrapAlignment(params, alignment, bootstrap_alignment, sample);
+        IQTree *boot_tree = newBootstrapTree(params, alignment, tree, bootstrap_alignment);
 
         // set checkpoint
         boot_tree->setCheckpoint(tree->getCheckpoint());
-        boot_tree->num_precision = tree->num_precision;
 
         runTreeReconstruction(params, boot_tree);
         // read in the output tree file
@@ -3607,17 +4009,20 @@ void runStandardBootstrap(Params &params, Alignment *alignment, IQTree *tree) {
     }
 
     if (params.compute_ml_tree) {
-        cout << endl << "===> START ANALYSIS ON THE ORIGINAL ALIGNMENT" << endl << endl;
         // restore branch tests
         params.aLRT_replicates = saved_aLRT_replicates;
         params.localbp_replicates = saved_localbp_replicates;
         params.aLRT_test = saved_aLRT_test;
         params.aBayes_test = saved_aBayes_test;
 
-        if (params.num_runs == 1)
-            runTreeReconstruction(params, tree);
-        else
-            runMultipleTreeReconstruction(params, tree->aln, tree);
+        // with --boot-warm the original alignment was analyzed before the replicates
+        if (!ml_tree_done) {
+            cout << endl << "===> START ANALYSIS ON THE ORIGINAL ALIGNMENT" << endl << endl;
+            if (params.num_runs == 1)
+                runTreeReconstruction(params, tree);
+            else
+                runMultipleTreeReconstruction(params, tree->aln, tree);
+        }
 
         if (MPIHelper::getInstance().isMaster()) {
             if (params.consensus_type == CT_CONSENSUS_TREE && params.num_runs == 1) {
@@ -4113,7 +4518,14 @@ void runPhyloAnalysis(Params &params, Checkpoint *checkpoint, IQTree *&tree, Ali
         else
             alignment = new SuperAlignment(params);
     } else {
-        alignment = createAlignment(params.aln_file, params.sequence_type, params.intype, params.model_name);
+        vector<Alignment*> cached_alns;
+        if (AlignmentCache::load(params, cached_alns)) {
+            alignment = cached_alns[0];
+        } else {
+            alignment = createAlignment(params.aln_file, params.sequence_type, params.intype, params.model_name);
+            cached_alns.push_back(alignment);
+            AlignmentCache::save(params, cached_alns);
+        }
 
         if (params.freq_const_patterns) {
             int orig_nsite = alignment->getNSite();
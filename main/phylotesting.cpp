@@ -239,7 +239,7 @@ void CandidateModel::computeICScores(size_t sample_size) {
     computeInformationScores(logl, df, sample_size, AIC_score, AICc_score, BIC_score);
 }
 
-void CandidateModel::computeICScores() {
+size_t CandidateModel::getSampleSize() {
     size_t sample_size = aln->getNSite();
     if (aln->isSuperAlignment()) {
         sample_size = 0;
@@ -249,7 +249,11 @@ void CandidateModel::computeICScores() {
     }
     if (hasFlag(MF_SAMPLE_SIZE_TRIPLE))
         sample_size /= 3;
-    computeInformationScores(logl, df, sample_size, AIC_score, AICc_score, BIC_score);
+    return sample_size;
+}
+
+void CandidateModel::computeICScores() {
+    computeInformationScores(logl, df, getSampleSize(), AIC_score, AICc_score, BIC_score);
 }
 
 double CandidateModel::computeICScore(size_t sample_size) {
@@ -515,6 +519,45 @@ string criterionName(ModelTestCriterion mtc) {
 void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint &model_info,
                         ModelsBlock *models_block, int num_threads);
 
+#ifdef _IQTREE_MPI
+/**
+ * evaluate the candidate models of one alignment on all MPI processes
+ * @param[in,out] model_info (IN/OUT) all model information, identical on all processes afterwards
+ * @return best model
+ */
+CandidateModel evaluateModelsMPI(Params &params, PhyloTree *in_tree, ModelCheckpoint &model_info,
+                                 ModelsBlock *models_block, int num_threads, int brlen_type);
+#endif
+
+/** number of candidate models whose parameters were optimized, for the models/second report */
+static int64_t num_optimized_models = 0;
+
+/** number of candidate models warm-started from a nested model */
+static int64_t num_warm_started_models = 0;
+
+/** number of candidate models whose optimization was cut short */
+static int64_t num_aborted_models = 0;
+
+/**
+ @param rate rate heterogeneity name, e.g. +I+R4
+ @return rate with one FreeRate category less, e.g. +I+R3, or "" if rate is not a FreeRate model
+ */
+string getRateMinusOneCat(const string &rate) {
+    size_t posR;
+    const char *rates[] = {"+R", "*R"};
+    for (int i = 0; i < sizeof(rates)/sizeof(char*); i++) {
+        if ((posR = rate.find(rates[i])) == string::npos)
+            continue;
+        const char *num = rate.c_str() + posR + 2;
+        char *end;
+        int cat = strtol(num, &end, 10);
+        if (end == num)
+            return "";
+        return rate.substr(0, posR+2) + convertIntToString(cat-1) + end;
+    }
+    return "";
+}
+
 
 /**
  compute log-adapter function according to Whelan et al. 2015
@@ -801,8 +844,8 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
     // Model already specifed, nothing to do here
     if (!empty_model_found && params.model_name.substr(0, 4) != "TEST" && params.model_name.substr(0, 2) != "MF")
         return;
-    if (MPIHelper::getInstance().getNumProcesses() > 1)
-        outError("Please use only 1 MPI process! We are currently working on the MPI parallelization of model selection.");
+    if (MPIHelper::getInstance().getNumProcesses() > 1 && (params.model_test_and_tree || params.modelomatic))
+        outError("Please use only 1 MPI process for ModelFinder with -mtree or ModelOMatic");
     // TODO: check if necessary
     //        if (iqtree.isSuperTree())
     //            ((PhyloSuperTree*) &iqtree)->mapTrees();
@@ -821,6 +864,10 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
     ok_model_file &= model_info.size() > 0;
     if (ok_model_file)
         cout << "NOTE: Restoring information from model checkpoint file " << model_info.getFileName() << endl;
+
+    // only the MPI master writes the model checkpoint
+    if (MPIHelper::getInstance().isWorker())
+        model_info.setFileName("");
     
     
     Checkpoint *orig_checkpoint = iqtree.getCheckpoint();
@@ -859,6 +906,26 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
             iqtree.saveCheckpoint();
         }
     }
+
+#ifdef _IQTREE_MPI
+    if (MPIHelper::getInstance().getNumProcesses() > 1) {
+        // all processes continue from the initial tree of the master
+        if (iqtree.isSuperTree() && MPIHelper::getInstance().isMaster())
+            iqtree.saveCheckpoint();
+        MPIHelper::getInstance().broadcastCheckpoint(&model_info);
+        if (MPIHelper::getInstance().isWorker()) {
+            iqtree.restoreCheckpoint();
+            if (iqtree.isSuperTree()) {
+                PhyloSuperTree *stree = (PhyloSuperTree*)&iqtree;
+                for (auto it = stree->begin(); it != stree->end(); it++) {
+                    model_info.startStruct((*it)->aln->name);
+                    (*it)->restoreCheckpoint();
+                    model_info.endStruct();
+                }
+            }
+        }
+    }
+#endif
     
     // also save initial tree to the original .ckp.gz checkpoint
     //        string initTree = iqtree.getTreeString();
@@ -880,6 +947,8 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
     }
 #endif
     
+    // time of the model selection alone, for the models/second report
+    double model_time = getRealTime();
 
     if (iqtree.isSuperTree()) {
         // partition model selection
@@ -895,6 +964,11 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
     } else {
         // single model selection
         CandidateModel best_model;
+#ifdef _IQTREE_MPI
+        if (MPIHelper::getInstance().getNumProcesses() > 1)
+            best_model = evaluateModelsMPI(params, &iqtree, model_info, models_block, params.num_threads, BRLEN_OPTIMIZE);
+        else
+#endif
         if (params.openmp_by_model)
             best_model = CandidateModelSet().evaluateAll(params, &iqtree,
                 model_info, models_block, params.num_threads, BRLEN_OPTIMIZE);
@@ -914,6 +988,7 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
         cout << "Best-fit model: " << iqtree.aln->model_name << " chosen according to "
             << criterionName(params.model_test_criterion) << endl;
     }
+    model_time = getRealTime() - model_time;
 
     delete models_block;
     
@@ -932,6 +1007,11 @@ void runModelFinder(Params &params, IQTree &iqtree, ModelCheckpoint &model_info)
     cout << "All model information printed to " << model_info.getFileName() << endl;
     cout << "CPU time for ModelFinder: " << cpu_time << " seconds (" << convert_time(cpu_time) << ")" << endl;
     cout << "Wall-clock time for ModelFinder: " << real_time << " seconds (" << convert_time(real_time) << ")" << endl;
+    if (model_time > 0.0)
+        cout << "ModelFinder optimized " << num_optimized_models << " models ("
+             << num_optimized_models / model_time << " models/second, "
+             << num_warm_started_models << " warm-started from nested models, "
+             << num_aborted_models << " cut short)" << endl;
     
     //        alignment = iqtree.aln;
     if (test_only) {
@@ -1560,15 +1640,161 @@ void fixPartitions(PhyloSuperTree* super_tree) {
     super_tree->deleteAllPartialLh();
 }
 
+/**
+    tree of one ModelFinder thread that stays alive across the candidate models
+    of one alignment: only the ModelFactory is exchanged between models, while
+    the nodes, the alignment-dependent arrays and the likelihood buffers are kept
+    as long as the next model fits into them
+ */
+class ModelEvalContext {
+public:
+
+    ModelEvalContext(Alignment *aln) {
+        this->aln = aln;
+        tree = new IQTree(aln);
+        busy = false;
+    }
+
+    ~ModelEvalContext() {
+        delete tree;
+    }
+
+    /** delete model factory, model and rate of the previous candidate model */
+    void releaseModel() {
+        ModelFactory *model_factory = tree->getModelFactory();
+        ModelSubst *model = tree->getModel();
+        RateHeterogeneity *site_rate = tree->getRate();
+        tree->setModelFactory(NULL);
+        // do not leave the tree pointing to the deleted model and rate
+        tree->setModel(NULL);
+        tree->setRate(NULL);
+        delete model_factory;
+        delete model;
+        delete site_rate;
+    }
+
+    /**
+        assign likelihood buffers to the tree, the existing buffers are only
+        freed if the current model needs more memory than they were sized for
+     */
+    void initializeAllPartialLh() {
+        ModelSubst *model = tree->getModel();
+        RateHeterogeneity *site_rate = tree->getRate();
+        ModelFactory *model_factory = tree->getModelFactory();
+        size_t nmix = model_factory->fused_mix_rate ? 1 : model->getNMixtures();
+        vector<size_t> shape = {model_factory->unobserved_ptns.size(), tree->getPartialLhSize(),
+            site_rate->getNRate() * nmix, site_rate->getNDiscreteRate() * nmix,
+            (size_t)model->getNMixtures(), tree->getBufferPartialLhSize()};
+        // buffer layout of +ASC depends on the number of unobserved patterns
+        bool fits = !model->isSiteSpecificModel() && !capacity.empty() && shape[0] == capacity[0];
+        for (size_t i = 1; fits && i < shape.size(); i++)
+            fits = shape[i] <= capacity[i];
+        if (!fits) {
+            tree->deleteAllPartialLh();
+            // number of partial likelihood slots depends on the block size
+            tree->getMemoryRequired();
+            capacity = shape;
+            if (model->isSiteSpecificModel())
+                capacity.clear();
+        }
+        tree->initializeAllPartialLh();
+    }
+
+    /** the tree */
+    IQTree *tree;
+
+    /** alignment of the tree */
+    Alignment *aln;
+
+    /** TRUE if a thread currently evaluates a model on this context */
+    bool busy;
+
+protected:
+
+    /** model-dependent sizes that the likelihood buffers were allocated for */
+    vector<size_t> capacity;
+};
+
+/** evaluation contexts of all ModelFinder threads */
+static vector<ModelEvalContext*> model_eval_contexts;
+
+/**
+    @param aln alignment
+    @return an idle evaluation context of aln, a new one if all are busy
+ */
+ModelEvalContext *acquireModelEvalContext(Alignment *aln) {
+    ModelEvalContext *context = NULL;
+#ifdef _OPENMP
+#pragma omp critical(model_eval_contexts)
+#endif
+    {
+        for (auto it = model_eval_contexts.begin(); it != model_eval_contexts.end(); it++)
+            if ((*it)->aln == aln && !(*it)->busy) {
+                context = *it;
+                break;
+            }
+        if (!context) {
+            context = new ModelEvalContext(aln);
+            model_eval_contexts.push_back(context);
+        }
+        context->busy = true;
+    }
+    return context;
+}
+
+/** @param context evaluation context to give back */
+void releaseModelEvalContext(ModelEvalContext *context) {
+#ifdef _OPENMP
+#pragma omp critical(model_eval_contexts)
+#endif
+    context->busy = false;
+}
+
+/**
+    delete the evaluation contexts of an alignment, must be called before the alignment is deleted
+    @param aln alignment
+ */
+void deleteModelEvalContexts(Alignment *aln) {
+#ifdef _OPENMP
+#pragma omp critical(model_eval_contexts)
+#endif
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < model_eval_contexts.size(); i++)
+            if (model_eval_contexts[i]->aln == aln) {
+                ASSERT(!model_eval_contexts[i]->busy);
+                delete model_eval_contexts[i];
+            } else
+                model_eval_contexts[kept++] = model_eval_contexts[i];
+        model_eval_contexts.resize(kept);
+    }
+}
+
+/**
+    delete the evaluation contexts of all alignments of a candidate model set
+    @param models candidate models
+ */
+void deleteModelEvalContexts(CandidateModelSet &models) {
+    for (auto it = models.begin(); it != models.end(); it++)
+        deleteModelEvalContexts(it->aln);
+}
+
 string CandidateModel::evaluate(Params &params,
     ModelCheckpoint &in_model_info, ModelCheckpoint &out_model_info,
     ModelsBlock *models_block,
-    int &num_threads, int brlen_type)
+    int &num_threads, int brlen_type,
+    CandidateModel *nested_model, Checkpoint *nested_info)
 {
     //string model_name = name;
     Alignment *in_aln = aln;
     IQTree *iqtree = NULL;
-    if (in_aln->isSuperAlignment()) {
+    ModelEvalContext *context = NULL;
+    if (params.modelfinder_reuse_tree && !params.model_test_and_tree && !in_aln->isSuperAlignment() &&
+        posRateHeterotachy(getName()) == string::npos) {
+        context = acquireModelEvalContext(in_aln);
+        context->releaseModel();
+        iqtree = context->tree;
+    } else if (in_aln->isSuperAlignment()) {
         SuperAlignment *saln = (SuperAlignment*)in_aln;
         if (params.partition_type == BRLEN_OPTIMIZE)
             iqtree = new PhyloSuperTree(saln);
@@ -1604,7 +1830,10 @@ string CandidateModel::evaluate(Params &params,
 
 
     if (restoreCheckpoint(&in_model_info)) {
-        delete iqtree;
+        if (context)
+            releaseModelEvalContext(context);
+        else
+            delete iqtree;
         return "";
     }
 
@@ -1612,6 +1841,27 @@ string CandidateModel::evaluate(Params &params,
 #pragma omp critical
 #endif
     iqtree->getModelFactory()->restoreCheckpoint();
+
+    if (nested_info && !params.model_test_and_tree && !in_aln->isSuperAlignment()) {
+        // warm start from the tree and parameters of the nested model
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        {
+        iqtree->setCheckpoint(nested_info);
+        iqtree->PhyloTree::restoreCheckpoint();
+        iqtree->getModelFactory()->setCheckpoint(nested_info);
+        iqtree->getModelFactory()->restoreCheckpoint();
+        // +R[k] splits the largest category of +R[k-1]
+        string lower_rate = getRateMinusOneCat(rate_name);
+        if (!lower_rate.empty() && nested_model->subst_name == subst_name && nested_model->rate_name == lower_rate)
+            iqtree->getRate()->initFromCatMinusOne();
+        }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        num_warm_started_models++;
+    }
     
     // now switch to the output checkpoint
     iqtree->getModelFactory()->setCheckpoint(&out_model_info);
@@ -1666,7 +1916,21 @@ string CandidateModel::evaluate(Params &params,
             cout << "Optimizing model " << getName() << endl;
 
         iqtree->ensureNumberOfThreadsIsSet(nullptr);
-        iqtree->initializeAllPartialLh();
+        if (context)
+            context->initializeAllPartialLh();
+        else
+            iqtree->initializeAllPartialLh();
+
+        if (!abort_scores.empty()) {
+            double penalty[3];
+            computeInformationScores(0.0, df + iqtree->getModelFactory()->getNParameters(brlen_type),
+                abort_sample_size, penalty[0], penalty[1], penalty[2]);
+            // -2*logl + penalty must stay below the score to beat under at least one criterion
+            double abort_logl = DBL_MAX;
+            for (int i = 0; i < 3; i++)
+                abort_logl = min(abort_logl, (penalty[i] - abort_scores[i]) / 2.0);
+            iqtree->getModelFactory()->abort_logl = abort_logl - logl;
+        }
 
         for (int step = 0; step < 2; step++) {
             new_logl = iqtree->getModelFactory()->optimizeParameters(brlen_type, false,
@@ -1675,6 +1939,16 @@ string CandidateModel::evaluate(Params &params,
             iqtree->getModelFactory()->saveCheckpoint();
             iqtree->saveCheckpoint();
 
+            if (iqtree->getModelFactory()->optimization_aborted) {
+                if (verbose_mode >= VB_MED)
+                    cout << getName() << " cannot beat the best model, optimization cut short" << endl;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                num_aborted_models++;
+                break;
+            }
+
             // check if logl(+R[k]) is worse than logl(+R[k-1])
             CandidateModel prev_info;
             if (!prev_info.restoreCheckpointRminus1(&in_model_info, this)) break;
@@ -1703,7 +1977,15 @@ string CandidateModel::evaluate(Params &params,
     }
 #endif
 
-    delete iqtree;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    num_optimized_models++;
+
+    if (context)
+        releaseModelEvalContext(context);
+    else
+        delete iqtree;
     return tree_string;
 }
 
@@ -1779,6 +2061,7 @@ string CandidateModel::evaluateConcatenation(Params &params, SuperAlignment *sup
 
     computeICScores(ssize);
 
+    deleteModelEvalContexts(aln);
     delete aln;
     aln = NULL;
     return concat_tree;
@@ -1950,6 +2233,478 @@ void mergePairs(vector<SubsetPair> &dest, vector<SubsetPair> &src) {
             dest.push_back(s);
 }
 
+/**
+    select the best model for the union of two subsets of partitions
+    @param params program parameters
+    @param in_tree partitioned tree
+    @param model_info model information of all subsets
+    @param models_block model definitions
+    @param num_threads number of threads
+    @param merged_set IDs of the partitions in the union
+    @param set_name name of the union
+    @param set1 first subset
+    @param set2 second subset
+    @param tree_len initial tree length of the union
+    @param[out] part_model_info model information of the union
+    @return best model of the union
+*/
+CandidateModel testMergedSubset(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint &model_info,
+    ModelsBlock *models_block, int num_threads, set<int> &merged_set, string &set_name,
+    set<int> &set1, set<int> &set2, double tree_len, ModelCheckpoint &part_model_info)
+{
+    SuperAlignment *super_aln = ((SuperAlignment*)in_tree->aln);
+    Alignment *aln = super_aln->concatenateAlignments(merged_set);
+    PhyloTree *tree = in_tree->extractSubtree(merged_set);
+    tree->scaleLength(tree_len/tree->treeLength());
+    tree->setAlignment(aln);
+    extractModelInfo(set_name, model_info, part_model_info);
+    transferModelParameters(in_tree, model_info, part_model_info, set1, set2);
+    tree->num_precision = in_tree->num_precision;
+    tree->setParams(&params);
+    tree->sse = params.SSE;
+    tree->optimize_by_newton = params.optimize_by_newton;
+    tree->setNumThreads(num_threads);
+    {
+        tree->setCheckpoint(&part_model_info);
+        // trick to restore checkpoint
+        tree->restoreCheckpoint();
+        tree->saveCheckpoint();
+    }
+    CandidateModel best_model = CandidateModelSet().test(params, tree, part_model_info, models_block,
+        num_threads, params.partition_type, set_name, "", true);
+    best_model.restoreCheckpoint(&part_model_info);
+    delete tree;
+    delete aln;
+    return best_model;
+}
+
+/**
+    get the best model of a subset selected before, e.g. by MPI jobs
+    @param tree tree of the subset, gets the best tree if one was kept
+    @param part_model_info model information of the subset
+    @return best model of the subset, its scores still need restoreCheckpoint()
+*/
+CandidateModel getSelectedModel(PhyloTree *tree, ModelCheckpoint &part_model_info) {
+    CandidateModel best_model;
+    bool check = part_model_info.getBestModel(best_model.subst_name);
+    ASSERT(check);
+    string best_tree;
+    if (part_model_info.getBestTree(best_tree))
+        tree->readTreeString(best_tree);
+    return best_model;
+}
+
+#ifdef _IQTREE_MPI
+
+/**
+    jobs of a ModelFinder phase evaluated by all MPI processes
+*/
+class ModelJobSet {
+public:
+
+    virtual ~ModelJobSet() {}
+
+    /**
+        @return ID of the next job to hand out, -1 if no job is ready until a running job finished (master)
+    */
+    virtual int64_t getNextJob() = 0;
+
+    /**
+        information a worker needs in addition to its copy of the model checkpoint (master)
+        @param job job ID
+        @param[out] hint checkpoint sent along with the job
+    */
+    virtual void prepareJob(int64_t job, ModelCheckpoint &hint) {}
+
+    /**
+        evaluate a job (worker)
+        @param job job ID
+        @param hint checkpoint from prepareJob()
+        @param[out] result checkpoint sent back to the master
+    */
+    virtual void computeJob(int64_t job, ModelCheckpoint &hint, ModelCheckpoint &result) = 0;
+
+    /**
+        merge the result of a job into the model checkpoint (master)
+        @param job job ID
+        @param result checkpoint from computeJob()
+    */
+    virtual void collectJob(int64_t job, ModelCheckpoint &result) = 0;
+
+    /**
+        called after all jobs were collected, before model_info is broadcast (master)
+    */
+    virtual void finishJobs() {}
+};
+
+/**
+    send a job to a worker (master)
+    @param jobs the jobs
+    @param job job ID, -1 to let the worker leave
+    @param worker process ID of the worker
+*/
+void sendModelJob(ModelJobSet &jobs, int64_t job, int worker) {
+    ModelCheckpoint hint;
+    if (job >= 0)
+        jobs.prepareJob(job, hint);
+    CkpStream out;
+    out << job << endl;
+    hint.dump(out);
+    string reply = out.str();
+    MPIHelper::getInstance().sendString(reply, worker, MF_JOB_TAG);
+}
+
+/**
+    run ModelFinder jobs in MPI master/worker mode: workers pull job IDs from the
+    master until none is left, the master collects all results into model_info,
+    which is finally broadcast so that every process continues with the same information.
+    A job may depend on the results of others, then idle workers wait for it.
+    @param jobs the jobs
+    @param model_info model checkpoint
+*/
+void runModelJobs(ModelJobSet &jobs, ModelCheckpoint &model_info) {
+    MPIHelper &mpi = MPIHelper::getInstance();
+    // workers start from the information of the master
+    mpi.broadcastCheckpoint(&model_info);
+    if (mpi.isMaster()) {
+        int num_workers = mpi.getNumProcesses()-1;
+        int num_running = 0;
+        bool finished = false;
+        IntVector idle_workers;
+        while (num_workers > 0) {
+            string msg;
+            int worker = mpi.recvString(msg, MPI_ANY_SOURCE, MF_RESULT_TAG);
+            if (!msg.empty()) {
+                // result of the previous job of this worker
+                CkpStream in(msg);
+                ModelCheckpoint result;
+                int64_t job;
+                in >> job;
+                result.load(in);
+                jobs.collectJob(job, result);
+                num_running--;
+            }
+            idle_workers.push_back(worker);
+            int64_t job;
+            while (!idle_workers.empty() && (job = jobs.getNextJob()) >= 0) {
+                sendModelJob(jobs, job, idle_workers.back());
+                idle_workers.pop_back();
+                num_running++;
+            }
+            if (num_running == 0) {
+                // no job can become ready any more
+                if (!finished)
+                    jobs.finishJobs();
+                finished = true;
+                for (auto w : idle_workers)
+                    sendModelJob(jobs, -1, w);
+                num_workers -= idle_workers.size();
+                idle_workers.clear();
+            }
+        }
+    } else {
+        string msg;
+        while (true) {
+            mpi.sendString(msg, PROC_MASTER, MF_RESULT_TAG);
+            string reply;
+            mpi.recvString(reply, PROC_MASTER, MF_JOB_TAG);
+            CkpStream in(reply);
+            int64_t job;
+            in >> job;
+            if (job < 0)
+                break;
+            ModelCheckpoint hint, result;
+            hint.load(in);
+            jobs.computeJob(job, hint, result);
+            CkpStream out;
+            out << job << endl;
+            result.dump(out);
+            msg = out.str();
+        }
+    }
+    mpi.broadcastCheckpoint(&model_info);
+}
+
+/**
+    candidate models of one alignment as MPI jobs. The master hands out the models
+    in the order of test() and applies its rules, so that the outcome does not depend
+    on which worker finishes first: +R[k] waits for +R[k-1], the rate and substitution
+    filters are applied once their block finished, and the models of the rate
+    heterogeneity test wait for the best substitution model.
+*/
+class CandidateModelJobs : public ModelJobSet {
+public:
+
+    CandidateModelJobs(CandidateModelSet &models, Params &params, ModelCheckpoint &model_info,
+                       ModelsBlock *models_block, int num_threads, int brlen_type, bool merge_phase)
+        : models(models), params(params), model_info(model_info)
+    {
+        this->models_block = models_block;
+        this->num_threads = num_threads;
+        this->brlen_type = brlen_type;
+        best_score = DBL_MAX;
+        bool auto_rate = merge_phase ? iEquals(params.merge_rates, "AUTO") : iEquals(params.ratehet_set, "AUTO");
+        bool auto_subst = merge_phase ? iEquals(params.merge_models, "AUTO") : iEquals(params.model_set, "AUTO");
+        rate_block = models.size();
+        if (auto_rate) {
+            for (rate_block = 0; rate_block < models.size(); rate_block++)
+                if (rate_block+1 < models.size() && models[rate_block+1].subst_name != models[rate_block].subst_name)
+                    break;
+        }
+        subst_block = models.size();
+        if (auto_subst) {
+            for (subst_block = models.size()-1; subst_block >= 0; subst_block--)
+                if (models[subst_block].rate_name == models[0].rate_name)
+                    break;
+        }
+        // like test(), filter only if models follow the block
+        rates_filtered = (rate_block+1 >= models.size());
+        subst_filtered = (subst_block+1 >= models.size());
+        separate_rate_model = -1;
+    }
+
+    virtual int64_t getNextJob() {
+        if (!rates_filtered && isFinished(rate_block)) {
+            models.filterRates(rate_block); // auto filter rate models
+            rates_filtered = true;
+        }
+        if (!subst_filtered && isFinished(subst_block)) {
+            models.filterSubst(subst_block); // auto filter substitution model
+            subst_filtered = true;
+        }
+        for (int64_t model = 0; model < models.size(); model++) {
+            if (models[model].hasFlag(MF_IGNORED + MF_RUNNING + MF_DONE))
+                continue;
+            if ((model > rate_block && !rates_filtered) || (model > subst_block && !subst_filtered))
+                break;
+            // needed to check logl(+R[k]) against logl(+R[k-1])
+            if (model > 0 && models.getHigherKModel(model-1) == model && !isFinished(model-1))
+                continue;
+            if (models[model].subst_name.empty()) {
+                // now switching to test rate heterogeneity
+                if (separate_rate_model < 0)
+                    separate_rate_model = model;
+                if (!isFinished(separate_rate_model-1))
+                    break;
+                if (separate_subst_name.empty())
+                    separate_subst_name = models[models.getBestModelID(params.model_test_criterion)].subst_name;
+                models[model].subst_name = separate_subst_name;
+            }
+            models[model].setFlag(MF_RUNNING);
+            return model;
+        }
+        return -1;
+    }
+
+    virtual void prepareJob(int64_t model, ModelCheckpoint &hint) {
+        hint.put("subst_name", models[model].subst_name);
+        int lower_model = models.getLowerKModel(model);
+        if (lower_model >= 0) {
+            ModelCheckpoint lower_info;
+            models[lower_model].saveCheckpoint(&lower_info);
+            hint.putSubCheckpoint(&lower_info, "lower");
+        }
+    }
+
+    virtual void computeJob(int64_t model, ModelCheckpoint &hint, ModelCheckpoint &result) {
+        CandidateModel &info = models[model];
+        hint.getString("subst_name", info.subst_name);
+        ModelCheckpoint lower_info;
+        string lower = "lower";
+        extractModelInfo(lower, hint, lower_info);
+        model_info.putSubCheckpoint(&lower_info, "");
+        ModelCheckpoint out_model_info;
+        models.evaluateModel(model, params, model_info, out_model_info, models_block, num_threads, brlen_type);
+        // evaluate() may have changed the model name
+        result.put("subst_name", info.subst_name);
+        result.put("rate_name", info.rate_name);
+        info.saveCheckpoint(&out_model_info);
+        result.putSubCheckpoint(&out_model_info, "out");
+    }
+
+    virtual void collectJob(int64_t model, ModelCheckpoint &result) {
+        CandidateModel &info = models[model];
+        result.getString("subst_name", info.subst_name);
+        result.getString("rate_name", info.rate_name);
+        ModelCheckpoint out_model_info;
+        string out = "out";
+        extractModelInfo(out, result, out_model_info);
+        bool check = info.restoreCheckpoint(&out_model_info);
+        ASSERT(check);
+        info.saveCheckpoint(&model_info);
+        out_model_info.erase(info.getName());
+        info.computeICScores();
+        info.setFlag(MF_DONE);
+
+        int lower_model = models.getLowerKModel(model);
+        if (lower_model >= 0 && models[lower_model].getScore() < info.getScore()) {
+            // ignore all +R_k model with higher category
+            for (int higher_model = model; higher_model != -1;
+                higher_model = models.getHigherKModel(higher_model)) {
+                models[higher_model].setFlag(MF_IGNORED);
+            }
+        }
+        if (best_score > info.getScore()) {
+            best_score = info.getScore();
+            // only update model_info with better model
+            model_info.putSubCheckpoint(&out_model_info, "");
+        }
+        model_info.dump();
+        models.printModel(model);
+    }
+
+    virtual void finishJobs() {
+        models.saveBestModels(model_info);
+    }
+
+protected:
+
+    /** @return TRUE if all models up to the given one finished or were ignored */
+    bool isFinished(int64_t last_model) {
+        for (int64_t model = 0; model <= last_model; model++)
+            if (!models[model].hasFlag(MF_DONE + MF_IGNORED))
+                return false;
+        return true;
+    }
+
+    CandidateModelSet &models;
+    Params &params;
+    ModelCheckpoint &model_info;
+    ModelsBlock *models_block;
+    int num_threads;
+    int brlen_type;
+    int rate_block, subst_block;
+    bool rates_filtered, subst_filtered;
+    /** first model of the rate heterogeneity test and the best substitution model for it */
+    int64_t separate_rate_model;
+    string separate_subst_name;
+    double best_score;
+};
+
+CandidateModel evaluateModelsMPI(Params &params, PhyloTree *in_tree, ModelCheckpoint &model_info,
+                                 ModelsBlock *models_block, int num_threads, int brlen_type)
+{
+    in_tree->params = &params;
+    CandidateModelSet models;
+    models.generate(params, in_tree->aln, params.model_test_separate_rate, false);
+    if (params.modelfinder_warm_start)
+        models.initNestedModels();
+    if (MPIHelper::getInstance().isMaster()) {
+        cout << "ModelFinder will test " << models.size() << " " << getSeqTypeName(in_tree->aln->seq_type)
+             << " models (sample size: " << in_tree->aln->getNSite() << ") on "
+             << MPIHelper::getInstance().getNumProcesses()-1 << " MPI workers ..." << endl;
+        cout << " No. Model         -LnL         df  AIC          AICc         BIC" << endl;
+    }
+    CandidateModelJobs jobs(models, params, model_info, models_block, num_threads, brlen_type, false);
+    runModelJobs(jobs, model_info);
+    deleteModelEvalContexts(models);
+
+    // the master selected the best model, restore it from the broadcast information
+    CandidateModel best_model;
+    bool check = model_info.getBestModel(best_model.subst_name);
+    ASSERT(check);
+    check = best_model.restoreCheckpoint(&model_info);
+    ASSERT(check);
+    return best_model;
+}
+
+/**
+    model selection for subsets of partitions as MPI jobs, one job per subset:
+    either a single partition or the union of two subsets for merging
+*/
+class SubsetModelJobs : public ModelJobSet {
+public:
+
+    SubsetModelJobs(Params &params, PhyloSuperTree *in_tree, ModelCheckpoint &model_info,
+                    ModelsBlock *models_block, int num_threads, int brlen_type, bool merge_phase)
+        : params(params), model_info(model_info)
+    {
+        this->in_tree = in_tree;
+        this->models_block = models_block;
+        this->num_threads = num_threads;
+        this->brlen_type = brlen_type;
+        this->merge_phase = merge_phase;
+        next_job = 0;
+    }
+
+    /** add model selection for partition part */
+    void addPartition(int part) {
+        Subset subset;
+        subset.part = part;
+        subset.set_name = in_tree->at(part)->aln->name;
+        subset.tree_len = 0.0;
+        subsets.push_back(subset);
+    }
+
+    /** add model selection for the union of two subsets with initial tree length tree_len */
+    void addPair(set<int> &set1, set<int> &set2, double tree_len) {
+        Subset subset;
+        subset.part = -1;
+        subset.set1 = set1;
+        subset.set2 = set2;
+        subset.merged_set.insert(set1.begin(), set1.end());
+        subset.merged_set.insert(set2.begin(), set2.end());
+        subset.set_name = getSubsetName(in_tree, subset.merged_set);
+        subset.tree_len = tree_len;
+        subsets.push_back(subset);
+    }
+
+    size_t size() {
+        return subsets.size();
+    }
+
+    virtual int64_t getNextJob() {
+        if (next_job >= subsets.size())
+            return -1;
+        return next_job++;
+    }
+
+    virtual void computeJob(int64_t job, ModelCheckpoint &hint, ModelCheckpoint &result) {
+        Subset &subset = subsets[job];
+        ModelCheckpoint part_model_info;
+        if (subset.part >= 0) {
+            PhyloTree *this_tree = in_tree->at(subset.part);
+            extractModelInfo(subset.set_name, model_info, part_model_info);
+            string part_model_name;
+            if (params.model_name.empty())
+                part_model_name = this_tree->aln->model_name;
+            CandidateModelSet().test(params, this_tree, part_model_info, models_block,
+                num_threads, brlen_type, subset.set_name, part_model_name, merge_phase);
+        } else {
+            testMergedSubset(params, in_tree, model_info, models_block, num_threads,
+                subset.merged_set, subset.set_name, subset.set1, subset.set2, subset.tree_len, part_model_info);
+        }
+        result.putSubCheckpoint(&part_model_info, "");
+    }
+
+    virtual void collectJob(int64_t job, ModelCheckpoint &result) {
+        replaceModelInfo(subsets[job].set_name, model_info, result);
+        model_info.dump();
+    }
+
+protected:
+
+    /** a partition (part >= 0) or the union of set1 and set2 */
+    struct Subset {
+        int part;
+        set<int> set1, set2, merged_set;
+        string set_name;
+        double tree_len;
+    };
+
+    vector<Subset> subsets;
+    size_t next_job;
+    Params &params;
+    PhyloSuperTree *in_tree;
+    ModelCheckpoint &model_info;
+    ModelsBlock *models_block;
+    int num_threads;
+    int brlen_type;
+    bool merge_phase;
+};
+
+#endif
+
 /**
  * select models for all partitions
  * @param[in,out] model_info (IN/OUT) all model information
@@ -2052,6 +2807,19 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
         brlen_type = BRLEN_OPTIMIZE;
     }
     bool test_merge = (params.partition_merge != MERGE_NONE) && params.partition_type != TOPO_UNLINKED && (in_tree->size() > 1);
+    // the loops below then only collect the selected models
+    bool selected_by_mpi = false;
+
+#ifdef _IQTREE_MPI
+    if (MPIHelper::getInstance().getNumProcesses() > 1) {
+        // select partition models on all processes
+        SubsetModelJobs jobs(params, in_tree, model_info, models_block, num_threads, brlen_type, test_merge);
+        for (int j = 0; j < in_tree->size(); j++)
+            jobs.addPartition(partitionID[j].first);
+        runModelJobs(jobs, model_info);
+        selected_by_mpi = true;
+    }
+#endif
     
 #ifdef _OPENMP
     parallel_over_partitions = !params.model_test_and_tree && (in_tree->size() >= num_threads);
@@ -2068,8 +2836,11 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
         if (params.model_name.empty())
             part_model_name = this_tree->aln->model_name;
         CandidateModel best_model;
-		best_model = CandidateModelSet().test(params, this_tree, part_model_info, models_block,
-            (parallel_over_partitions ? 1 : num_threads), brlen_type, this_tree->aln->name, part_model_name, test_merge);
+        if (selected_by_mpi)
+            best_model = getSelectedModel(this_tree, part_model_info);
+        else
+            best_model = CandidateModelSet().test(params, this_tree, part_model_info, models_block,
+                (parallel_over_partitions ? 1 : num_threads), brlen_type, this_tree->aln->name, part_model_name, test_merge);
 
         bool check = (best_model.restoreCheckpoint(&part_model_info));
         ASSERT(check);
@@ -2118,8 +2889,10 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
     pre_inf_score = inf_score;
 
 	if (!test_merge) {
-		super_aln->printBestPartition((string(params.out_prefix) + ".best_scheme.nex").c_str());
-		super_aln->printBestPartitionRaxml((string(params.out_prefix) + ".best_scheme").c_str());
+        if (MPIHelper::getInstance().isMaster()) {
+            super_aln->printBestPartition((string(params.out_prefix) + ".best_scheme.nex").c_str());
+            super_aln->printBestPartitionRaxml((string(params.out_prefix) + ".best_scheme").c_str());
+        }
         model_info.dump();
 		return;
 	}
@@ -2192,6 +2965,28 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
         size_t num_pairs = closest_pairs.size();
         size_t compute_pairs = 0;
 
+#ifdef _IQTREE_MPI
+        if (MPIHelper::getInstance().getNumProcesses() > 1) {
+            // merge new pairs on all processes, the loop below restores them like pairs done before
+            SubsetModelJobs jobs(params, in_tree, model_info, models_block, num_threads, params.partition_type, true);
+            for (size_t pair = 0; pair < num_pairs; pair++) {
+                int part1 = closest_pairs[pair].first, part2 = closest_pairs[pair].second;
+                set<int> merged_set;
+                merged_set.insert(gene_sets[part1].begin(), gene_sets[part1].end());
+                merged_set.insert(gene_sets[part2].begin(), gene_sets[part2].end());
+                string best_model_name;
+                model_info.startStruct(getSubsetName(in_tree, merged_set));
+                bool done_before = model_info.getBestModel(best_model_name);
+                model_info.endStruct();
+                if (!done_before)
+                    jobs.addPair(gene_sets[part1], gene_sets[part2], sqrt(lenvec[part1]*lenvec[part2]));
+            }
+            runModelJobs(jobs, model_info);
+            num_model += jobs.size();
+            compute_pairs += jobs.size();
+        }
+#endif
+
 #ifdef _OPENMP
 #pragma omp parallel for private(i) schedule(dynamic) if(!params.model_test_and_tree)
 #endif
@@ -2224,32 +3019,11 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
                 model_info.endStruct();
             }
             ModelCheckpoint part_model_info;
-            double cur_tree_len = 0.0;
             if (!done_before) {
-                Alignment *aln = super_aln->concatenateAlignments(cur_pair.merged_set);
-                PhyloTree *tree = in_tree->extractSubtree(cur_pair.merged_set);
-                //tree->scaleLength((weight1*lenvec[cur_pair.part1] + weight2*lenvec[cur_pair.part2])/tree->treeLength());
-                tree->scaleLength(sqrt(lenvec[cur_pair.part1]*lenvec[cur_pair.part2])/tree->treeLength());
-                cur_tree_len = tree->treeLength();
-                tree->setAlignment(aln);
-                extractModelInfo(cur_pair.set_name, model_info, part_model_info);
-                transferModelParameters(in_tree, model_info, part_model_info, gene_sets[cur_pair.part1], gene_sets[cur_pair.part2]);
-                tree->num_precision = in_tree->num_precision;
-                tree->setParams(&params);
-                tree->sse = params.SSE;
-                tree->optimize_by_newton = params.optimize_by_newton;
-                tree->setNumThreads(params.model_test_and_tree ? num_threads : 1);
-                {
-                    tree->setCheckpoint(&part_model_info);
-                    // trick to restore checkpoint
-                    tree->restoreCheckpoint();
-                    tree->saveCheckpoint();
-                }
-                best_model = CandidateModelSet().test(params, tree, part_model_info, models_block,
-                    params.model_test_and_tree ? num_threads : 1, params.partition_type, cur_pair.set_name, "", true);
-                best_model.restoreCheckpoint(&part_model_info);
-                delete tree;
-                delete aln;
+                best_model = testMergedSubset(params, in_tree, model_info, models_block,
+                    params.model_test_and_tree ? num_threads : 1, cur_pair.merged_set, cur_pair.set_name,
+                    gene_sets[cur_pair.part1], gene_sets[cur_pair.part2],
+                    sqrt(lenvec[cur_pair.part1]*lenvec[cur_pair.part2]), part_model_info);
             }
             cur_pair.logl = best_model.logl;
             cur_pair.df = best_model.df;
@@ -2396,6 +3170,16 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
             std::sort(partitionID.begin(), partitionID.end(), comparePartition);
         }
 
+#ifdef _IQTREE_MPI
+        if (MPIHelper::getInstance().getNumProcesses() > 1) {
+            // select models of merged partitions on all processes
+            SubsetModelJobs jobs(params, in_tree, model_info, models_block, num_threads, brlen_type, false);
+            for (int j = 0; j < in_tree->size(); j++)
+                jobs.addPartition(partitionID[j].first);
+            runModelJobs(jobs, model_info);
+        }
+#endif
+
         cout << endl;
         cout << "No. Model        Score       Charset" << endl;
         int partition_id = 0;
@@ -2415,9 +3199,12 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
             if (params.model_name.empty())
                 part_model_name = this_tree->aln->model_name;
             CandidateModel best_model;
-            best_model = CandidateModelSet().test(params, this_tree, part_model_info, models_block,
-                (parallel_over_partitions ? 1 : num_threads), brlen_type,
-                this_tree->aln->name, part_model_name, false);
+            if (selected_by_mpi)
+                best_model = getSelectedModel(this_tree, part_model_info);
+            else
+                best_model = CandidateModelSet().test(params, this_tree, part_model_info, models_block,
+                    (parallel_over_partitions ? 1 : num_threads), brlen_type,
+                    this_tree->aln->name, part_model_name, false);
             
             bool check = (best_model.restoreCheckpoint(&part_model_info));
             ASSERT(check);
@@ -2454,8 +3241,10 @@ void testPartitionModel(Params &params, PhyloSuperTree* in_tree, ModelCheckpoint
     inf_score = computeInformationScore(lhsum, dfsum, ssize, params.model_test_criterion);
     cout << "Best partition model " << criterionName(params.model_test_criterion) << " score: " << inf_score << " (LnL: " << lhsum << "  df:" << dfsum << ")" << endl;
 
-    ((SuperAlignment*)in_tree->aln)->printBestPartition((string(params.out_prefix) + ".best_scheme.nex").c_str());
-	((SuperAlignment*)in_tree->aln)->printBestPartitionRaxml((string(params.out_prefix) + ".best_scheme").c_str());
+    if (MPIHelper::getInstance().isMaster()) {
+        ((SuperAlignment*)in_tree->aln)->printBestPartition((string(params.out_prefix) + ".best_scheme.nex").c_str());
+        ((SuperAlignment*)in_tree->aln)->printBestPartitionRaxml((string(params.out_prefix) + ".best_scheme").c_str());
+    }
     model_info.dump();
 }
 
@@ -2566,6 +3355,8 @@ CandidateModel CandidateModelSet::test(Params &params, PhyloTree* in_tree, Model
     } else {
         push_back(CandidateModel(in_model_name, "", in_tree->aln));
     }
+    if (params.modelfinder_warm_start)
+        initNestedModels();
 
     DoubleVector model_scores;
     int model;
@@ -2662,8 +3453,8 @@ CandidateModel CandidateModelSet::test(Params &params, PhyloTree* in_tree, Model
         string tree_string;
 
         /***** main call to estimate model parameters ******/
-        tree_string = at(model).evaluate(params,
-            model_info, out_model_info, models_block, num_threads, brlen_type);
+        tree_string = evaluateModel(model, params,
+            model_info, out_model_info, models_block, num_threads, brlen_type, ssize);
 
         at(model).computeICScores(ssize);
         at(model).setFlag(MF_DONE);
@@ -2830,6 +3621,8 @@ CandidateModel CandidateModelSet::test(Params &params, PhyloTree* in_tree, Model
     checkpoint->dump();
 
 	delete [] model_rank;
+
+    deleteModelEvalContexts(*this);
     
     // update alignment if best data type changed
     if (best_aln != in_tree->aln) {
@@ -2859,6 +3652,120 @@ CandidateModel CandidateModelSet::test(Params &params, PhyloTree* in_tree, Model
 	return at(best_model);
 }
 
+CandidateModelSet::~CandidateModelSet() {
+    for (auto it = optimized_params.begin(); it != optimized_params.end(); it++)
+        delete *it;
+}
+
+void CandidateModelSet::initNestedModels() {
+    map<pair<Alignment*, string>, int> model_ids;
+    for (int model = 0; model < size(); model++)
+        model_ids[make_pair(at(model).aln, at(model).orig_subst_name + at(model).orig_rate_name)] = model;
+    nested_models.assign(size(), -1);
+    optimized_params.resize(size(), NULL);
+    for (int model = 0; model < size(); model++) {
+        CandidateModel &info = at(model);
+        string rate = info.orig_rate_name;
+        if (rate.empty() || posRateHeterotachy(rate) != string::npos)
+            continue;
+        // candidates from the most to the least similar model
+        StrVector lower_rates;
+        lower_rates.push_back(getRateMinusOneCat(rate));
+        size_t pos = rate.find("+I");
+        if (pos != string::npos && rate != "+I")
+            lower_rates.push_back(rate.substr(0, pos) + rate.substr(pos+2));
+        pos = rate.find_last_of("+*");
+        if (pos != string::npos && pos > 0)
+            lower_rates.push_back(rate.substr(0, pos));
+        lower_rates.push_back("");
+        for (auto it = lower_rates.begin(); it != lower_rates.end(); it++) {
+            if (it->empty() && it+1 != lower_rates.end())
+                continue;
+            auto nested = model_ids.find(make_pair(info.aln, info.orig_subst_name + *it));
+            // only earlier models, so that a model can wait for its nested model
+            if (nested != model_ids.end() && nested->second < model) {
+                nested_models[model] = nested->second;
+                break;
+            }
+        }
+    }
+}
+
+bool CandidateModelSet::isNestedModelPending(int model) {
+    int nested = getNestedModel(model);
+    // a running model may be ignored meanwhile, its parameters are still wanted
+    return nested >= 0 && !at(nested).hasFlag(MF_DONE) &&
+        (at(nested).hasFlag(MF_RUNNING) || !at(nested).hasFlag(MF_IGNORED));
+}
+
+int CandidateModelSet::getWarmStartModel(int model) {
+    // only the nested model, so that the start does not depend on which models finished first
+    int nested = getNestedModel(model);
+    if (nested >= 0 && optimized_params[nested])
+        return nested;
+    return -1;
+}
+
+void CandidateModelSet::setOptimizedParams(int model, Checkpoint *model_params) {
+    if (model >= optimized_params.size()) {
+        delete model_params;
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp critical(warm_start)
+#endif
+    {
+    delete optimized_params[model];
+    optimized_params[model] = model_params;
+    }
+}
+
+string CandidateModelSet::evaluateModel(int model, Params &params,
+    ModelCheckpoint &in_model_info, ModelCheckpoint &out_model_info,
+    ModelsBlock *models_block, int &num_threads, int brlen_type, size_t sample_size)
+{
+    CandidateModel *nested_model = NULL;
+    Checkpoint *nested_info = NULL;
+    at(model).abort_scores.clear();
+    if (params.modelfinder_abort_margin >= 0.0 && !params.model_test_and_tree) {
+        DoubleVector best_scores(3, DBL_MAX);
+        ModelTestCriterion criteria[] = {MTC_AIC, MTC_AICC, MTC_BIC};
+#ifdef _OPENMP
+#pragma omp critical(warm_start)
+#endif
+        for (int i = 0; i < size(); i++)
+            if (at(i).hasFlag(MF_DONE))
+                for (int c = 0; c < 3; c++)
+                    best_scores[c] = min(best_scores[c], at(i).getScore(criteria[c]));
+        if (best_scores[0] < DBL_MAX) {
+            for (int c = 0; c < 3; c++)
+                at(model).abort_scores.push_back(best_scores[c] + params.modelfinder_abort_margin);
+            at(model).abort_sample_size = sample_size ? sample_size : at(model).getSampleSize();
+        }
+    }
+    if (params.modelfinder_warm_start) {
+#ifdef _OPENMP
+#pragma omp critical(warm_start)
+#endif
+        {
+        int nested = getWarmStartModel(model);
+        if (nested >= 0) {
+            nested_model = &at(nested);
+            nested_info = optimized_params[nested];
+        }
+        }
+    }
+    string tree_string = at(model).evaluate(params, in_model_info, out_model_info,
+        models_block, num_threads, brlen_type, nested_model, nested_info);
+    if (model < optimized_params.size() && !out_model_info.empty()) {
+        // keep the optimized parameters for the models nested above this one
+        Checkpoint *model_params = new Checkpoint;
+        model_params->putSubCheckpoint(&out_model_info, "");
+        setOptimizedParams(model, model_params);
+    }
+    return tree_string;
+}
+
 int64_t CandidateModelSet::getNextModel() {
     int64_t next_model;
 #pragma omp critical
@@ -2868,21 +3775,84 @@ int64_t CandidateModelSet::getNextModel() {
     else if (current_model == -1)
         next_model = 0;
     else {
-        for (next_model = current_model+1; next_model != current_model; next_model++) {
-            if (next_model == size())
-                next_model = 0;
-            if (!at(next_model).hasFlag(MF_IGNORED + MF_WAITING + MF_RUNNING)) {
-                break;
+        // rank 2: nested model finished (warm start), 1: no nested model,
+        // models whose nested model is pending wait for it
+        int best_rank = -1;
+        bool waiting = false;
+        next_model = current_model;
+        for (int64_t i = 1; i <= size(); i++) {
+            int64_t model = (current_model + i) % size();
+            if (at(model).hasFlag(MF_IGNORED + MF_WAITING + MF_RUNNING))
+                continue;
+            if (isNestedModelPending(model)) {
+                waiting = true;
+                continue;
+            }
+            int nested = getNestedModel(model);
+            int rank = (nested >= 0 && at(nested).hasFlag(MF_DONE)) ? 2 : 1;
+            if (rank > best_rank) {
+                best_rank = rank;
+                next_model = model;
+                if (rank == 2)
+                    break;
             }
         }
+        if (best_rank < 0 && waiting)
+            next_model = -2;
     }
-    }
-    if (next_model != current_model) {
+    if (next_model >= 0 && next_model != current_model) {
         current_model = next_model;
         at(next_model).setFlag(MF_RUNNING);
-        return next_model;
-    } else
-        return -1;
+    } else if (next_model != -2)
+        next_model = -1;
+    }
+    return next_model;
+}
+
+void CandidateModelSet::printModel(int64_t model) {
+    cout.width(3);
+    cout << right << model+1 << "  ";
+    cout.width(13);
+    cout << left << at(model).getName() << " ";
+
+    cout.precision(3);
+    cout << fixed;
+    cout.width(12);
+    cout << -at(model).logl << " ";
+    cout.width(3);
+    cout << at(model).df << " ";
+    cout.width(12);
+    cout << at(model).AIC_score << " ";
+    cout.width(12);
+    cout << at(model).AICc_score << " " << at(model).BIC_score;
+    cout << endl;
+}
+
+void CandidateModelSet::saveBestModels(ModelCheckpoint &model_info) {
+    // store the best model
+    ModelTestCriterion criteria[] = {MTC_AIC, MTC_AICC, MTC_BIC};
+    for (auto mtc : criteria) {
+        int best_model = getBestModelID(mtc);
+        model_info.put("best_score_" + criterionName(mtc), at(best_model).getScore(mtc));
+        model_info.put("best_model_" + criterionName(mtc), at(best_model).getName());
+    }
+    
+    
+    /* sort models by their scores */
+    multimap<double,int> model_sorted;
+    for (int64_t model = 0; model < size(); model++)
+        if (at(model).hasFlag(MF_DONE)) {
+            model_sorted.insert(multimap<double,int>::value_type(at(model).getScore(), model));
+        }
+    string model_list;
+    for (auto it = model_sorted.begin(); it != model_sorted.end(); it++) {
+        if (it != model_sorted.begin())
+            model_list += " ";
+        model_list += at(it->second).getName();
+    }
+    
+    model_info.putBestModelList(model_list);
+    model_info.dump();
 }
 
 CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree, ModelCheckpoint &model_info,
@@ -2928,6 +3898,8 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
     } else {
         push_back(CandidateModel(in_model_name, "", in_tree->aln));
     }
+    if (params.modelfinder_warm_start)
+        initNestedModels();
 
     if (write_info) {
         cout << "ModelFinder will test " << size() << " ";
@@ -2958,7 +3930,6 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
                 break;
     }
 
-    int64_t num_models = size();
 #ifdef _OPENMP
 #pragma omp parallel num_threads(num_threads)
 #endif
@@ -2968,6 +3939,11 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
         model = getNextModel();
         if (model == -1)
             break;
+        if (model == -2) {
+            // wait for a nested model to finish
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
 
         // optimize model parameters
         string orig_model_name = at(model).getName();
@@ -2977,8 +3953,8 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
         string tree_string;
         
         // main call to estimate model parameters
-        tree_string = at(model).evaluate(params, model_info, out_model_info,
-                                         models_block, num_threads, brlen_type);
+        tree_string = evaluateModel(model, params, model_info, out_model_info,
+                                    models_block, num_threads, brlen_type);
         at(model).computeICScores();
         at(model).setFlag(MF_DONE);
         
@@ -3004,25 +3980,8 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
             model_info.putSubCheckpoint(&out_model_info, "");
         }
         model_info.dump();
-        if (write_info) {
-            cout.width(3);
-            cout << right << model+1 << "  ";
-            cout.width(13);
-            cout << left << at(model).getName() << " ";
-            
-            cout.precision(3);
-            cout << fixed;
-            cout.width(12);
-            cout << -at(model).logl << " ";
-            cout.width(3);
-            cout << at(model).df << " ";
-            cout.width(12);
-            cout << at(model).AIC_score << " ";
-            cout.width(12);
-            cout << at(model).AICc_score << " " << at(model).BIC_score;
-            cout << endl;
-
-        }
+        if (write_info)
+            printModel(model);
         if (model >= rate_block)
             filterRates(model); // auto filter rate models
         if (model >= subst_block)
@@ -3033,30 +3992,9 @@ CandidateModel CandidateModelSet::evaluateAll(Params &params, PhyloTree* in_tree
     } while (model != -1);
     }
     
-    // store the best model
-    ModelTestCriterion criteria[] = {MTC_AIC, MTC_AICC, MTC_BIC};
-    for (auto mtc : criteria) {
-        int best_model = getBestModelID(mtc);
-        model_info.put("best_score_" + criterionName(mtc), at(best_model).getScore(mtc));
-        model_info.put("best_model_" + criterionName(mtc), at(best_model).getName());
-    }
-    
-    
-    /* sort models by their scores */
-    multimap<double,int> model_sorted;
-    for (int64_t model = 0; model < num_models; model++)
-        if (at(model).hasFlag(MF_DONE)) {
-            model_sorted.insert(multimap<double,int>::value_type(at(model).getScore(), model));
-        }
-    string model_list;
-    for (auto it = model_sorted.begin(); it != model_sorted.end(); it++) {
-        if (it != model_sorted.begin())
-            model_list += " ";
-        model_list += at(it->second).getName();
-    }
-    
-    model_info.putBestModelList(model_list);
-    model_info.dump();
+    saveBestModels(model_info);
+
+    deleteModelEvalContexts(*this);
 
     // update alignment if best data type changed
     int best_model = getBestModelID(params.model_test_criterion);
@@ -39,6 +39,7 @@ public:
         AIC_score = DBL_MAX;
         AICc_score = DBL_MAX;
         BIC_score = DBL_MAX;
+        abort_sample_size = 0;
         this->flag = flag;
     }
     
@@ -73,11 +74,14 @@ public:
      @param models_block models block
      @param num_thread number of threads
      @param brlen_type BRLEN_OPTIMIZE | BRLEN_FIX | BRLEN_SCALE | TOPO_UNLINKED
+     @param nested_model finished nested model to warm-start from, NULL to start from defaults
+     @param nested_info optimized parameters and tree of nested_model
      @return tree string
      */
     string evaluate(Params &params,
                     ModelCheckpoint &in_model_info, ModelCheckpoint &out_model_info,
-                    ModelsBlock *models_block, int &num_threads, int brlen_type);
+                    ModelsBlock *models_block, int &num_threads, int brlen_type,
+                    CandidateModel *nested_model = NULL, Checkpoint *nested_info = NULL);
     
     /**
      evaluate concatenated alignment
@@ -91,6 +95,9 @@ public:
     void computeICScores(size_t sample_size);
     void computeICScores();
 
+    /** @return default sample size of the alignment used by computeICScores() */
+    size_t getSampleSize();
+
     /**
      compute information criterion scores (AIC, AICc, BIC)
      */
@@ -166,6 +173,10 @@ public:
     double AIC_weight, AICc_weight, BIC_weight; // weights
     bool AIC_conf, AICc_conf, BIC_conf;         // in confidence set?
 
+    /** AIC, AICc and BIC that evaluate() must be able to beat, otherwise its optimization is cut short (empty: never) */
+    DoubleVector abort_scores;
+    size_t abort_sample_size; // sample size for abort_scores
+
     Alignment *aln; // associated alignment
     
 protected:
@@ -183,6 +194,8 @@ public:
     CandidateModelSet() : vector<CandidateModel>() {
         current_model = -1;
     }
+
+    ~CandidateModelSet();
     
     /** get ID of the best model */
     int getBestModelID(ModelTestCriterion mtc);
@@ -271,7 +284,72 @@ public:
         return -1;
     }
 
-    /** get the next model to evaluate in parallel */
+    /**
+     find the nested model of every candidate model, must be called after all models are generated:
+     XXX+R[k-1] for XXX+R[k], XXX+G for XXX+I+G and XXX for XXX+G or XXX+I
+     */
+    void initNestedModels();
+
+    /**
+     @param model model index
+     @return nested model of model (always evaluated before it), -1 if none
+     */
+    int getNestedModel(int model) {
+        return (model < nested_models.size()) ? nested_models[model] : -1;
+    }
+
+    /**
+     @param model model index
+     @return TRUE if model has to wait for its nested model to finish before it is evaluated
+     */
+    bool isNestedModelPending(int model);
+
+    /**
+     @param model model index
+     @return finished nested model whose parameters model is warm-started from, -1 if none
+     */
+    int getWarmStartModel(int model);
+
+    /**
+     @param model model index
+     @return optimized parameters of a finished model, NULL if not kept
+     */
+    Checkpoint *getOptimizedParams(int model) {
+        return (model < optimized_params.size()) ? optimized_params[model] : NULL;
+    }
+
+    /**
+     replace the optimized parameters of a model, e.g. by those received from another process
+     @param model model index
+     @param model_params parameters (taken over by this object) or NULL
+     */
+    void setOptimizedParams(int model, Checkpoint *model_params);
+
+    /**
+     evaluate a model warm-started from a finished nested model, see CandidateModel::evaluate()
+     a model that cannot beat the best finished model under any criterion is cut short
+     @param model model index
+     @param sample_size sample size of the information criteria, 0 for the default of the model
+     @return tree string
+     */
+    string evaluateModel(int model, Params &params,
+                         ModelCheckpoint &in_model_info, ModelCheckpoint &out_model_info,
+                         ModelsBlock *models_block, int &num_threads, int brlen_type,
+                         size_t sample_size = 0);
+
+    /** print the scores of a finished model as a row of the ModelFinder table */
+    void printModel(int64_t model);
+
+    /**
+     save the best model of every criterion and the list of finished models sorted by score
+     @param model_info (OUT) model information
+     */
+    void saveBestModels(ModelCheckpoint &model_info);
+
+    /**
+     get the next model to evaluate in parallel, preferring models whose nested model has finished
+     @return model index, -1 if all models are taken, -2 if the remaining models wait for a running one
+     */
     int64_t getNextModel();
 
     /**
@@ -282,9 +360,21 @@ public:
                      string in_model_name = "", bool merge_phase = false, bool write_info = true);
     
 private:
+
+    /** Disable copy constructor, the object owns optimized_params */
+    CandidateModelSet(const CandidateModelSet &);
+
+    /** Disable assignment operator */
+    CandidateModelSet &operator=(const CandidateModelSet &);
     
     /** current model */
     int64_t current_model;
+
+    /** index of the nested model of each model, -1 if none */
+    vector<int> nested_models;
+
+    /** optimized parameters and tree of each finished model, NULL if not kept */
+    vector<Checkpoint*> optimized_params;
 };
 
 //typedef vector<ModelInfo> ModelCheckpoint;
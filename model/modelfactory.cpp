@@ -135,6 +135,8 @@ ModelFactory::ModelFactory() : CheckpointFactory() {
     joint_optimize = false;
     fused_mix_rate = false;
     ASC_type = ASC_NONE;
+    abort_logl = -DBL_MAX;
+    optimization_aborted = false;
 }
 
 size_t findCloseBracket(string &str, size_t start_pos) {
@@ -154,6 +156,8 @@ ModelFactory::ModelFactory(Params &params, string &model_name, PhyloTree *tree,
     joint_optimize = params.optimize_model_rate_joint;
     fused_mix_rate = false;
     ASC_type = ASC_NONE;
+    abort_logl = -DBL_MAX;
+    optimization_aborted = false;
     string model_str = model_name;
     string rate_str;
 
@@ -1385,6 +1389,9 @@ double ModelFactory::optimizeParameters(int fixed_len, bool write_info,
         // cout << "tree->params->num_param_iterations has increased to " << tree->params->num_param_iterations << endl;
     }
 
+    optimization_aborted = false;
+    double prev_improvement = 0.0;
+
     for (i = 2; i < tree->params->num_param_iterations; i++) {
         double new_lh;
 
@@ -1415,6 +1422,7 @@ double ModelFactory::optimizeParameters(int fixed_len, bool write_info,
                 cout << "Scaled tree length: " << tree->treeLength() << endl;
         }
         if (new_lh > cur_lh + logl_epsilon) {
+            double improvement = new_lh - cur_lh;
             cur_lh = new_lh;
             if (write_info) {
                 if (verbose_mode >= VB_MED) {
@@ -1425,6 +1433,17 @@ double ModelFactory::optimizeParameters(int fixed_len, bool write_info,
                     cout << i << ". Current log-likelihood: " << cur_lh << endl;
                 }
             }
+            // improvements decreasing geometrically by ratio r sum up to at most improvement*r/(1-r)
+            if (abort_logl > -DBL_MAX && i > 2 && improvement < prev_improvement) {
+                double ratio = improvement / prev_improvement;
+                if (cur_lh + improvement * ratio / (1.0 - ratio) < abort_logl) {
+                    if (verbose_mode >= VB_MED)
+                        cout << "Optimization stopped, log-likelihood cannot reach " << abort_logl << endl;
+                    optimization_aborted = true;
+                    break;
+                }
+            }
+            prev_improvement = improvement;
         } else {
             site_rate->classifyRates(new_lh);
             if (fixed_len == BRLEN_OPTIMIZE)
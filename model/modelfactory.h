@@ -242,6 +242,15 @@ public:
 
     /** ascertainment bias correction type */
     ASCType ASC_type;
+
+    /**
+        optimizeParameters() gives up once the log-likelihood plus an estimate of the
+        remaining improvement falls below this value (default: -DBL_MAX, never)
+    */
+    double abort_logl;
+
+    /** TRUE if the last optimizeParameters() was cut short because of abort_logl */
+    bool optimization_aborted;
     
     ASCType getASC() { return ASC_type; }
     void setASC(ASCType new_ASC_type){ ASC_type = new_ASC_type; }
@@ -0,0 +1,39 @@
+#!/bin/bash -
+#===============================================================================
+#
+#          FILE: bench_modelfinder.sh
+#
+#         USAGE: ./bench_modelfinder.sh <iqtree_binary> [<alignment>] [<num_threads>]
+#
+#   DESCRIPTION: Compare ModelFinder throughput (models/second) with and
+#                without re-using the per-thread trees (--mf-no-reuse)
+#
+#       OPTIONS: ---
+#  REQUIREMENTS: ---
+#          BUGS: ---
+#         NOTES: ---
+#===============================================================================
+
+set -o nounset                              # Treat unset variables as an error
+
+if [ $# -lt 1 ]
+then
+    echo "USAGE: $0 <iqtree_binary> [<alignment>] [<num_threads>]" >&2
+    exit 1
+fi
+
+binary=$1
+aln=${2:-$(dirname $0)/test_data/example.phy}
+threads=${3:-1}
+out_dir=$(mktemp -d)
+
+for mode in "--mf-no-reuse" ""
+do
+    prefix=$out_dir/bench${mode}
+    $binary -s $aln -m MF -nt $threads -seed 1 -redo -quiet $mode -pre $prefix > /dev/null || exit 1
+    if [ -z "$mode" ]; then label="reuse trees"; else label="new tree per model"; fi
+    echo "$label: $(grep 'models/second' $prefix.log)"
+    grep "Best-fit model" $prefix.log
+done
+
+rm -rf $out_dir
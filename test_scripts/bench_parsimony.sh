@@ -0,0 +1,35 @@
+#!/bin/bash
+#
+# Times the random stepwise-addition parsimony trees of each SIMD kernel (-lk)
+# on a simulated alignment. The AVX512 kernel needs a binary built with
+# IQTREE_FLAGS=KNL and a CPU with AVX-512.
+#
+# Usage: bench_parsimony.sh <iqtree_binary> [<num_taxa>] [<num_sites>] [<kernels>]
+#
+
+set -o nounset
+
+if [ $# -lt 1 ]
+then
+    echo "USAGE: $0 <iqtree_binary> [<num_taxa>] [<num_sites>] [<kernels>]" >&2
+    exit 1
+fi
+
+binary=$1
+ntaxa=${2:-500}
+nsites=${3:-5000}
+kernels=${4:-"SSE AVX FMA AVX512"}
+out_dir=$(mktemp -d)
+
+# simulate the benchmark alignment once
+$binary --alisim $out_dir/sim -t "RANDOM{yh,$ntaxa}" -m JC --length $nsites -seed 1 -redo > /dev/null || exit 1
+
+for kernel in $kernels
+do
+    prefix=$out_dir/bench_$kernel
+    # one search iteration, as -n 0 skips the initial parsimony trees
+    $binary -s $out_dir/sim.phy -m JC -t PARS -n 1 -ninit 100 -nt 1 -lk $kernel -seed 1 -redo -quiet -pre $prefix > /dev/null || exit 1
+    echo "$kernel ($(grep '^Kernel:' $prefix.log | cut -c10-)): $(grep 'parsimony trees' $prefix.log)"
+done
+
+rm -rf $out_dir
@@ -0,0 +1,43 @@
+#!/bin/bash
+# bench_stepwise_addition.sh <iqtree_binary> [<num_taxa>] [<num_sites>]
+#
+# Builds one random stepwise-addition parsimony tree (-t PARS) on a simulated
+# alignment twice: with the incremental insertion costs and with full
+# rescoring (--pars-no-incr). The runs share the seed, so the trees must match.
+
+set -o nounset
+
+if [ $# -lt 1 ]
+then
+    echo "USAGE: $0 <iqtree_binary> [<num_taxa>] [<num_sites>]" >&2
+    exit 1
+fi
+
+binary=$1
+ntaxa=${2:-10000}
+nsites=${3:-1000}
+out_dir=$(mktemp -d)
+
+# simulate the benchmark alignment once
+$binary --alisim $out_dir/sim -t "RANDOM{yh,$ntaxa}" -m JC --length $nsites -seed 1 -redo > /dev/null || exit 1
+
+for mode in incremental full
+do
+    prefix=$out_dir/bench_$mode
+    opt=""
+    if [ $mode == full ]
+    then
+        opt="--pars-no-incr"
+    fi
+    $binary -s $out_dir/sim.phy -m JC -t PARS -n 0 -nt 1 -seed 1 $opt -redo -quiet -pre $prefix > /dev/null || exit 1
+    echo "$mode: $(grep 'parsimony score' $prefix.log)"
+done
+
+if cmp -s $out_dir/bench_incremental.parstree $out_dir/bench_full.parstree
+then
+    echo "Identical parsimony trees"
+else
+    echo "ERROR: parsimony trees differ" >&2
+fi
+
+rm -rf $out_dir
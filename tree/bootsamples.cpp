@@ -0,0 +1,100 @@
+//
+// C++ Implementation: bootsamples
+//
+// Description: compact pattern counts of ultrafast bootstrap replicates
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#include "phylotree.h"
+#include "bootsamples.h"
+
+BootSamples::BootSamples() {
+    nsamples = nptn = stride = 0;
+    count_type = BOOT_COUNT_UINT8;
+    mem = NULL;
+}
+
+BootSamples::~BootSamples() {
+    clear();
+}
+
+void BootSamples::init(int nsamples, size_t nptn, size_t stride) {
+    clear();
+    ASSERT(stride >= nptn);
+    this->nsamples = nsamples;
+    this->nptn = nptn;
+    this->stride = stride;
+    count_type = BOOT_COUNT_UINT8;
+    uint8_t *bytes = aligned_alloc<uint8_t>(getMemoryUsage());
+    memset(bytes, 0, getMemoryUsage());
+    mem = bytes;
+}
+
+void BootSamples::clear() {
+    if (mem) {
+        uint8_t *bytes = (uint8_t*)mem;
+        aligned_free(bytes);
+        mem = NULL;
+    }
+    nsamples = nptn = stride = 0;
+    count_type = BOOT_COUNT_UINT8;
+}
+
+void BootSamples::widen(BootCountType new_type) {
+    ASSERT(new_type > count_type);
+    size_t total = nsamples*stride;
+    size_t new_bytes = (new_type == BOOT_COUNT_UINT16) ? 2 : sizeof(float);
+    uint8_t *new_mem = aligned_alloc<uint8_t>(total*new_bytes);
+    for (size_t pos = 0; pos < total; pos++) {
+        int count = getCount(pos / stride, pos % stride);
+        if (new_type == BOOT_COUNT_UINT16)
+            ((uint16_t*)new_mem)[pos] = count;
+        else
+            ((float*)new_mem)[pos] = count;
+    }
+    uint8_t *bytes = (uint8_t*)mem;
+    aligned_free(bytes);
+    mem = new_mem;
+    count_type = new_type;
+}
+
+void BootSamples::setSample(int sample, const IntVector &counts) {
+    ASSERT(sample < nsamples && counts.size() >= nptn);
+    int max_count = 0;
+    for (size_t ptn = 0; ptn < nptn; ptn++)
+        max_count = max(max_count, counts[ptn]);
+    if (max_count > UINT16_MAX && count_type < BOOT_COUNT_FLOAT)
+        widen(BOOT_COUNT_FLOAT);
+    else if (max_count > UINT8_MAX && count_type < BOOT_COUNT_UINT16)
+        widen(BOOT_COUNT_UINT16);
+    void *row = getRow(sample);
+    for (size_t ptn = 0; ptn < nptn; ptn++) {
+        switch (count_type) {
+        case BOOT_COUNT_UINT8: ((uint8_t*)row)[ptn] = counts[ptn]; break;
+        case BOOT_COUNT_UINT16: ((uint16_t*)row)[ptn] = counts[ptn]; break;
+        default: ((float*)row)[ptn] = counts[ptn]; break;
+        }
+    }
+}
+
+double BootSamples::dotProduct(int sample, const double *ptn_lh) const {
+    double sum = 0.0;
+    void *row = getRow(sample);
+    switch (count_type) {
+    case BOOT_COUNT_UINT8:
+        for (size_t ptn = 0; ptn < nptn; ptn++)
+            sum += ptn_lh[ptn] * ((uint8_t*)row)[ptn];
+        break;
+    case BOOT_COUNT_UINT16:
+        for (size_t ptn = 0; ptn < nptn; ptn++)
+            sum += ptn_lh[ptn] * ((uint16_t*)row)[ptn];
+        break;
+    default:
+        for (size_t ptn = 0; ptn < nptn; ptn++)
+            sum += ptn_lh[ptn] * ((float*)row)[ptn];
+        break;
+    }
+    return sum;
+}
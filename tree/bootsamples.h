@@ -0,0 +1,136 @@
+//
+// C++ Interface: bootsamples
+//
+// Description: compact pattern counts of ultrafast bootstrap replicates
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#ifndef BOOTSAMPLES_H
+#define BOOTSAMPLES_H
+
+#include "utils/tools.h"
+
+/** storage type of bootstrap pattern counts */
+enum BootCountType {BOOT_COUNT_UINT8, BOOT_COUNT_UINT16, BOOT_COUNT_FLOAT};
+
+/**
+    Pattern counts of all UFBoot replicates as one row-major matrix.
+
+    Resampled pattern counts are small integers, so every count is stored with
+    the narrowest of uint8_t, uint16_t or float that holds all counts seen so
+    far; the matrix is widened when setSample() meets a larger count. With
+    uint8_t the matrix needs a quarter of the memory of a float matrix.
+    Each row has getStride() entries, the entries after the last pattern are zero.
+*/
+class BootSamples {
+public:
+
+    BootSamples();
+
+    ~BootSamples();
+
+    /**
+        allocate a zero matrix of 8-bit counts
+        @param nsamples number of replicates
+        @param nptn number of patterns
+        @param stride number of entries per row, at least nptn
+     */
+    void init(int nsamples, size_t nptn, size_t stride);
+
+    /** release all memory */
+    void clear();
+
+    /**
+        store the pattern counts of one replicate, widening the matrix if needed
+        @param sample replicate index
+        @param counts count of every pattern, at least nptn entries
+     */
+    void setSample(int sample, const IntVector &counts);
+
+    /**
+        @param sample replicate index
+        @param ptn pattern index
+        @return count of pattern ptn in replicate sample
+     */
+    inline int getCount(int sample, size_t ptn) const {
+        size_t pos = sample*stride + ptn;
+        switch (count_type) {
+        case BOOT_COUNT_UINT8: return ((uint8_t*)mem)[pos];
+        case BOOT_COUNT_UINT16: return ((uint16_t*)mem)[pos];
+        default: return ((float*)mem)[pos];
+        }
+    }
+
+    /**
+        @param sample replicate index
+        @return first entry of row sample, to be cast according to getCountType()
+     */
+    inline void *getRow(int sample) const {
+        return (char*)mem + sample*stride*getCountBytes();
+    }
+
+    /**
+        scalar RELL score of one replicate, for callers without SIMD kernels
+        @param sample replicate index
+        @param ptn_lh pattern log-likelihoods, nptn entries
+        @return sum of ptn_lh weighted by the counts of replicate sample
+     */
+    double dotProduct(int sample, const double *ptn_lh) const;
+
+    /** @return number of replicates */
+    inline size_t size() const {
+        return nsamples;
+    }
+
+    /** @return TRUE if no replicate is allocated */
+    inline bool empty() const {
+        return nsamples == 0;
+    }
+
+    /** @return storage type of the counts */
+    inline BootCountType getCountType() const {
+        return count_type;
+    }
+
+    /** @return number of bytes per count */
+    inline size_t getCountBytes() const {
+        return (count_type == BOOT_COUNT_UINT8) ? 1 : ((count_type == BOOT_COUNT_UINT16) ? 2 : sizeof(float));
+    }
+
+    /** @return number of entries per row */
+    inline size_t getStride() const {
+        return stride;
+    }
+
+    /** @return memory in bytes occupied by the matrix */
+    inline size_t getMemoryUsage() const {
+        return nsamples*stride*getCountBytes();
+    }
+
+protected:
+
+    /**
+        convert the matrix into a wider storage type
+        @param new_type new storage type, wider than count_type
+     */
+    void widen(BootCountType new_type);
+
+    /** number of replicates */
+    size_t nsamples;
+
+    /** number of patterns */
+    size_t nptn;
+
+    /** number of entries per row */
+    size_t stride;
+
+    /** storage type of the counts */
+    BootCountType count_type;
+
+    /** the matrix, aligned for SIMD loads */
+    void *mem;
+};
+
+#endif
@@ -0,0 +1,189 @@
+//
+// C++ Implementation: boottrees
+//
+// Description: deduplicated store of the best trees of ultrafast bootstrap replicates
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#include "boottrees.h"
+#include "mtree.h"
+
+BootTrees::BootTrees() {
+}
+
+BootTrees::~BootTrees() {
+    clear();
+}
+
+void BootTrees::init(size_t nsamples) {
+    clear();
+    tree_ids.resize(nsamples, -1);
+}
+
+void BootTrees::clear() {
+    tree_ids.clear();
+    topologies.clear();
+    free_ids.clear();
+    topology_index.clear();
+    dirty_ids.clear();
+    split_index.clear();
+    for (vector<Split*>::reverse_iterator it = splits.rbegin(); it != splits.rend(); it++)
+        delete (*it);
+    splits.clear();
+    split_counts.clear();
+}
+
+int BootTrees::findTree(size_t hash, const string &tree) const {
+    auto range = topology_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++)
+        if (topologies[it->second].tree == tree)
+            return it->second;
+    return -1;
+}
+
+int BootTrees::addTree(const string &tree, bool rooted) {
+    ASSERT(!tree.empty());
+    size_t hash = std::hash<string>()(tree);
+    int id = findTree(hash, tree);
+    if (id >= 0)
+        return id;
+
+    // parse the new tree once, the leaf names are taxon IDs like in MTreeSet::init()
+    MTree mtree;
+    stringstream ss(tree);
+    bool myrooted = rooted;
+    mtree.readTree(ss, myrooted);
+    NodeVector taxa;
+    mtree.getTaxa(taxa);
+    for (NodeVector::iterator it = taxa.begin(); it != taxa.end(); it++) {
+        if ((*it)->name == ROOT_NAME)
+            (*it)->id = taxa.size() - 1;
+        else
+            (*it)->id = atoi((*it)->name.c_str());
+    }
+    SplitGraph sg;
+    Split sp(mtree.leafNum);
+    mtree.convertSplits(sg, &sp, (NodeVector*)NULL);
+
+    if (free_ids.empty()) {
+        id = topologies.size();
+        topologies.resize(id+1);
+    } else {
+        id = free_ids.back();
+        free_ids.pop_back();
+    }
+    Topology &topo = topologies[id];
+    topo.tree = tree;
+    topo.hash = hash;
+    topo.count = topo.applied_count = 0;
+    topo.dirty = false;
+    topo.split_ids.clear();
+    for (SplitGraph::iterator it = sg.begin(); it != sg.end(); it++) {
+        int split_id;
+        if (!split_index.findSplit(*it, split_id)) {
+            split_id = splits.size();
+            Split *new_split = new Split(*(*it));
+            new_split->setWeight(0.0);
+            splits.push_back(new_split);
+            split_counts.push_back(0);
+            split_index.insertSplit(new_split, split_id);
+        }
+        topo.split_ids.push_back(split_id);
+    }
+    topology_index.insert(make_pair(hash, id));
+    // a tree not assigned to any replicate is freed by the next updateSplitCounts()
+    markDirty(id);
+    return id;
+}
+
+void BootTrees::markDirty(int id) {
+    if (topologies[id].dirty)
+        return;
+    topologies[id].dirty = true;
+    dirty_ids.push_back(id);
+}
+
+void BootTrees::setTreeID(size_t sample, int id) {
+    int old_id = tree_ids[sample];
+    if (old_id == id)
+        return;
+    if (old_id >= 0) {
+        topologies[old_id].count--;
+        markDirty(old_id);
+    }
+    if (id >= 0) {
+        topologies[id].count++;
+        markDirty(id);
+    }
+    tree_ids[sample] = id;
+}
+
+void BootTrees::setTree(size_t sample, const string &tree, bool rooted) {
+    setTreeID(sample, tree.empty() ? -1 : addTree(tree, rooted));
+}
+
+void BootTrees::updateSplitCounts() {
+    for (IntVector::iterator it = dirty_ids.begin(); it != dirty_ids.end(); it++) {
+        Topology &topo = topologies[*it];
+        int delta = topo.count - topo.applied_count;
+        if (delta != 0)
+            for (IntVector::iterator sit = topo.split_ids.begin(); sit != topo.split_ids.end(); sit++)
+                split_counts[*sit] += delta;
+        topo.applied_count = topo.count;
+        topo.dirty = false;
+        if (topo.count == 0) {
+            // no replicate has this tree any more
+            auto range = topology_index.equal_range(topo.hash);
+            for (auto rit = range.first; rit != range.second; rit++)
+                if (rit->second == *it) {
+                    topology_index.erase(rit);
+                    break;
+                }
+            string().swap(topo.tree);
+            IntVector().swap(topo.split_ids);
+            free_ids.push_back(*it);
+        }
+    }
+    dirty_ids.clear();
+}
+
+void BootTrees::convertSplits(vector<string> &taxname, SplitGraph &sg, SplitIntMap &hash_ss) {
+    updateSplitCounts();
+    sg.createBlocks();
+    for (vector<string>::iterator its = taxname.begin(); its != taxname.end(); its++)
+        sg.getTaxa()->AddTaxonLabel(NxsString(its->c_str()));
+    for (size_t id = 0; id < splits.size(); id++) {
+        if (split_counts[id] == 0)
+            continue;
+        Split *sp = new Split(*splits[id]);
+        sp->setWeight(split_counts[id]);
+        sg.push_back(sp);
+        hash_ss.insertSplit(sp, split_counts[id]);
+    }
+}
+
+void BootTrees::getTrees(StrVector &trees) const {
+    trees.resize(size());
+    for (size_t sample = 0; sample < size(); sample++)
+        trees[sample] = (*this)[sample];
+}
+
+size_t BootTrees::getNumTrees() const {
+    size_t num = 0;
+    for (vector<Topology>::const_iterator it = topologies.begin(); it != topologies.end(); it++)
+        if (it->count > 0)
+            num++;
+    return num;
+}
+
+void BootTrees::getDistinctTrees(StrVector &trees, IntVector &counts) const {
+    trees.clear();
+    counts.clear();
+    for (vector<Topology>::const_iterator it = topologies.begin(); it != topologies.end(); it++)
+        if (it->count > 0) {
+            trees.push_back(it->tree);
+            counts.push_back(it->count);
+        }
+}
@@ -0,0 +1,185 @@
+//
+// C++ Interface: boottrees
+//
+// Description: deduplicated store of the best trees of ultrafast bootstrap replicates
+//
+//
+// Copyright: See COPYING file that comes with this distribution
+//
+//
+#ifndef BOOTTREES_H
+#define BOOTTREES_H
+
+#include "utils/tools.h"
+#include "pda/splitgraph.h"
+#include "pda/hashsplitset.h"
+
+/**
+    Best trees of the UFBoot replicates. Every distinct tree string is interned
+    once, together with its split set, and a replicate only holds the index of
+    its tree. The number of replicates containing each split is updated
+    incrementally whenever replicates change their trees, so that split supports
+    can be computed without parsing the trees of all replicates.
+
+    Tree strings carry taxon IDs as leaf names, as printed by saveCurrentTree().
+*/
+class BootTrees {
+public:
+
+    BootTrees();
+
+    ~BootTrees();
+
+    /**
+        reset the store to nsamples replicates without a tree
+        @param nsamples number of replicates
+     */
+    void init(size_t nsamples);
+
+    /** release all memory */
+    void clear();
+
+    /** @return number of replicates */
+    inline size_t size() const {
+        return tree_ids.size();
+    }
+
+    /** @return TRUE if there is no replicate */
+    inline bool empty() const {
+        return tree_ids.empty();
+    }
+
+    /**
+        @param sample replicate index
+        @return tree string of replicate sample, empty if it has no tree yet
+     */
+    inline const string &operator[](size_t sample) const {
+        int id = tree_ids[sample];
+        return (id < 0) ? empty_tree : topologies[id].tree;
+    }
+
+    /**
+        @param sample replicate index
+        @return tree index of replicate sample, -1 if it has no tree yet
+     */
+    inline int getTreeID(size_t sample) const {
+        return tree_ids[sample];
+    }
+
+    /**
+        intern a tree, parsing it only if it is not stored yet
+        @param tree tree string with taxon IDs as leaf names
+        @param rooted TRUE if the tree is rooted
+        @return tree index
+     */
+    int addTree(const string &tree, bool rooted);
+
+    /**
+        assign a stored tree to a replicate;
+        split counts are brought up-to-date by updateSplitCounts()
+        @param sample replicate index
+        @param id tree index from addTree(), or -1 to remove the tree of the replicate
+     */
+    void setTreeID(size_t sample, int id);
+
+    /**
+        intern a tree and assign it to a replicate
+        @param sample replicate index
+        @param tree tree string with taxon IDs as leaf names
+        @param rooted TRUE if the tree is rooted
+     */
+    void setTree(size_t sample, const string &tree, bool rooted);
+
+    /**
+        apply the pending changes of setTreeID() to the split counts
+        and free the trees no longer used by any replicate
+     */
+    void updateSplitCounts();
+
+    /**
+        convert the split counts into a split graph, like MTreeSet::convertSplits() with SW_COUNT
+        @param taxname taxon names, indexed by taxon ID
+        @param[out] sg splits occurring in some replicate, weighted by number of replicates
+        @param[out] hash_ss map from the splits in sg to their counts
+     */
+    void convertSplits(vector<string> &taxname, SplitGraph &sg, SplitIntMap &hash_ss);
+
+    /**
+        @param[out] trees tree string of every replicate
+     */
+    void getTrees(StrVector &trees) const;
+
+    /** @return number of distinct trees in use */
+    size_t getNumTrees() const;
+
+    /**
+        @param[out] trees the distinct trees in use
+        @param[out] counts number of replicates of each tree in trees
+     */
+    void getDistinctTrees(StrVector &trees, IntVector &counts) const;
+
+protected:
+
+    /** one interned tree */
+    struct Topology {
+        /** tree string, empty if the entry is free */
+        string tree;
+
+        /** hash of tree */
+        size_t hash;
+
+        /** index into splits for every split of the tree */
+        IntVector split_ids;
+
+        /** number of replicates having this tree */
+        int count;
+
+        /** count already added to split_counts */
+        int applied_count;
+
+        /** TRUE if listed in dirty_ids */
+        bool dirty;
+    };
+
+    /**
+        @param hash hash of tree
+        @param tree a tree string
+        @return tree index, -1 if not stored
+     */
+    int findTree(size_t hash, const string &tree) const;
+
+    /**
+        mark a tree whose count changed
+        @param id tree index
+     */
+    void markDirty(int id);
+
+    /** tree index of each replicate */
+    IntVector tree_ids;
+
+    /** interned trees */
+    vector<Topology> topologies;
+
+    /** unused entries in topologies */
+    IntVector free_ids;
+
+    /** map from tree hash to tree indices */
+    unordered_multimap<size_t, int> topology_index;
+
+    /** trees whose count differs from applied_count */
+    IntVector dirty_ids;
+
+    /** all splits seen so far, owned by this object */
+    vector<Split*> splits;
+
+    /** number of replicates containing each split */
+    IntVector split_counts;
+
+    /** map from split to its index in splits */
+    SplitIntMap split_index;
+
+    /** returned for replicates without a tree */
+    string empty_tree;
+};
+
+#endif
@@ -40,6 +40,9 @@ Params *globalParams;
 Alignment *globalAlignment;
 extern StringIntMap pllTreeCounter;
 
+/** number of UFBoot replicates whose RELL scores are computed together in saveCurrentTree() */
+const int BOOT_SAMPLE_BLOCK = 64;
+
 IQTree::IQTree() : PhyloTree() {
     IQTree::init();
 }
@@ -118,15 +121,38 @@ void IQTree::saveUFBoot(Checkpoint *checkpoint) {
         CKP_SAVE(logl_cutoff);
         int boot_splits_size = boot_splits.size();
         CKP_SAVE(boot_splits_size);
+        // every distinct tree is saved once below, replicates refer to it as @index
+        // ('#' would start a comment in the checkpoint file)
+        StrVector distinct_trees;
+        map<int, int> tree_index;
         checkpoint->startList(boot_samples.size());
         for (int id = 0; id != boot_samples.size(); id++) {
             checkpoint->addListElement();
             stringstream ss;
             ss.precision(10);
-            ss << boot_counts[id] << " " << boot_logl[id] << " " << boot_orig_logl[id] << " " << boot_trees[id];
+            ss << boot_counts[id] << " " << boot_logl[id] << " " << boot_orig_logl[id] << " ";
+            int tree_id = boot_trees.getTreeID(id);
+            if (tree_id >= 0) {
+                map<int, int>::iterator it = tree_index.find(tree_id);
+                if (it == tree_index.end()) {
+                    it = tree_index.insert(make_pair(tree_id, (int)distinct_trees.size())).first;
+                    distinct_trees.push_back(boot_trees[id]);
+                }
+                ss << "@" << it->second;
+            }
             checkpoint->put("", ss.str());
         }
         checkpoint->endList();
+        int num_boot_trees = distinct_trees.size();
+        CKP_SAVE(num_boot_trees);
+        checkpoint->endStruct();
+        checkpoint->startStruct("UFBootTree");
+        checkpoint->startList(num_boot_trees);
+        for (auto it = distinct_trees.begin(); it != distinct_trees.end(); it++) {
+            checkpoint->addListElement();
+            checkpoint->put("", *it);
+        }
+        checkpoint->endList();
     }
     checkpoint->endStruct();
 }
@@ -135,7 +161,7 @@ void IQTree::saveCheckpoint() {
     stop_rule.saveCheckpoint();
     candidateTrees.saveCheckpoint();
     
-    if (boot_samples.size() > 0 && !boot_trees.front().empty()) {
+    if (boot_samples.size() > 0 && !boot_trees[0].empty()) {
         saveUFBoot(checkpoint);
         // boot_splits
         int id = 0;
@@ -166,10 +192,13 @@ void IQTree::restoreUFBoot(Checkpoint *checkpoint) {
         checkpoint->getString("", str);
         ASSERT(!str.empty());
         stringstream ss(str);
-        ss >> boot_counts[id] >> boot_logl[id] >> boot_orig_logl[id] >> boot_trees[id];
+        string tree;
+        ss >> boot_counts[id] >> boot_logl[id] >> boot_orig_logl[id] >> tree;
+        boot_trees.setTree(id, tree, rooted);
     }
     checkpoint->endList();
     checkpoint->endStruct();
+    boot_trees.updateSplitCounts();
 }
 
 void IQTree::restoreCheckpoint() {
@@ -183,19 +212,42 @@ void IQTree::restoreCheckpoint() {
         CKP_RESTORE(logl_cutoff);
         // save boot_samples and boot_trees
         int id = 0;
+        int num_boot_trees = 0;
+        CKP_RESTORE(num_boot_trees);
+        checkpoint->endStruct();
+        // distinct trees, referred to as @index by the replicates
+        StrVector distinct_trees(num_boot_trees);
+        checkpoint->startStruct("UFBootTree");
+        checkpoint->startList(num_boot_trees);
+        for (id = 0; id < num_boot_trees; id++) {
+            checkpoint->addListElement();
+            checkpoint->getString("", distinct_trees[id]);
+        }
+        checkpoint->endList();
+        checkpoint->endStruct();
+
+        checkpoint->startStruct("UFBoot");
         checkpoint->startList(params->gbo_replicates);
-        boot_trees.resize(params->gbo_replicates);
+        boot_trees.init(params->gbo_replicates);
         boot_logl.resize(params->gbo_replicates);
         boot_orig_logl.resize(params->gbo_replicates);
         boot_counts.resize(params->gbo_replicates);
         for (id = 0; id < params->gbo_replicates; id++) {
             checkpoint->addListElement();
-            string str;
+            string str, tree;
             checkpoint->getString("", str);
             stringstream ss(str);
-            ss >> boot_counts[id] >> boot_logl[id] >> boot_orig_logl[id] >> boot_trees[id];
+            ss >> boot_counts[id] >> boot_logl[id] >> boot_orig_logl[id] >> tree;
+            if (!tree.empty() && tree[0] == '@') {
+                int tree_index = convert_int(tree.c_str()+1);
+                ASSERT(tree_index >= 0 && tree_index < num_boot_trees);
+                tree = distinct_trees[tree_index];
+            }
+            // older checkpoints store the tree string itself
+            boot_trees.setTree(id, tree, rooted);
         }
         checkpoint->endList();
+        boot_trees.updateSplitCounts();
         int boot_splits_size = 0;
         CKP_RESTORE(boot_splits_size);
         checkpoint->endStruct();
@@ -344,20 +396,18 @@ void IQTree::initSettings(Params &params) {
         
 //        cout << "Generating " << params.gbo_replicates << " samples for ultrafast "
 //             << RESAMPLE_NAME << " (seed: " << params.ran_seed << ")..." << endl;
-        // allocate memory for boot_samples
-        boot_samples.resize(params.gbo_replicates);
         sample_start = 0;
-        sample_end = boot_samples.size();
+        sample_end = params.gbo_replicates;
 
         // compute the sample_start and sample_end
         if (MPIHelper::getInstance().getNumProcesses() > 1) {
-            int num_samples = boot_samples.size() / MPIHelper::getInstance().getNumProcesses();
-            if (boot_samples.size() % MPIHelper::getInstance().getNumProcesses() != 0)
+            int num_samples = params.gbo_replicates / MPIHelper::getInstance().getNumProcesses();
+            if (params.gbo_replicates % MPIHelper::getInstance().getNumProcesses() != 0)
                 num_samples++;
             sample_start = MPIHelper::getInstance().getProcessID() * num_samples;
             sample_end = sample_start + num_samples;
-            if (sample_end > boot_samples.size())
-                sample_end = boot_samples.size();
+            if (sample_end > params.gbo_replicates)
+                sample_end = params.gbo_replicates;
         }
 
         size_t orig_nptn = getAlnNPattern();
@@ -366,15 +416,13 @@ void IQTree::initSettings(Params &params) {
 #else
         size_t nptn = get_safe_upper_limit(orig_nptn);
 #endif
-        BootValType *mem = aligned_alloc<BootValType>(nptn * (size_t)(params.gbo_replicates));
-        memset(mem, 0, nptn * (size_t)(params.gbo_replicates) * sizeof(BootValType));
-        for (i = 0; i < params.gbo_replicates; i++)
-            boot_samples[i] = mem + i*nptn;
+        // pattern counts are stored as 8-bit integers unless some count needs more
+        boot_samples.init(params.gbo_replicates, orig_nptn, nptn);
 
         if (boot_trees.empty()) {
             boot_logl.resize(params.gbo_replicates, -DBL_MAX);
             boot_orig_logl.resize(params.gbo_replicates, -DBL_MAX);
-            boot_trees.resize(params.gbo_replicates, "");
+            boot_trees.init(params.gbo_replicates);
             boot_counts.resize(params.gbo_replicates, 0);
         } else {
             cout << "CHECKPOINT: " << boot_trees.size() << " UFBoot trees and " << boot_splits.size() << " UFBootSplits restored" << endl;
@@ -390,15 +438,13 @@ void IQTree::initSettings(Params &params) {
                     bootstrap_alignment = new Alignment;
                 IntVector this_sample;
                 bootstrap_alignment->createBootstrapAlignment(aln, &this_sample, params.bootstrap_spec);
-                for (size_t j = 0; j < orig_nptn; j++)
-                    boot_samples[i][j] = this_sample[j];
+                boot_samples.setSample(i, this_sample);
                 bootstrap_alignment->printAlignment(params.aln_output_format, bootaln_name.c_str(), true);
                 delete bootstrap_alignment;
             } else {
                 IntVector this_sample;
                 aln->createBootstrapAlignment(this_sample, params.bootstrap_spec);
-                for (size_t j = 0; j < orig_nptn; j++)
-                    boot_samples[i][j] = this_sample[j];
+                boot_samples.setSample(i, this_sample);
             }
         }
         verbose_mode = saved_mode;
@@ -420,7 +466,7 @@ void IQTree::initSettings(Params &params) {
             for (size_t i = 0; i < params.gbo_replicates; i++) {
                 boot_samples_int[i].resize(nptn, 0);
                 for (size_t j = 0; j < orig_nptn; j++)
-                    boot_samples_int[i][j] = boot_samples[i][j];
+                    boot_samples_int[i][j] = boot_samples.getCount(i, j);
                }
         }
 
@@ -445,10 +491,9 @@ IQTree::~IQTree() {
     boot_splits.clear();
     //if (boot_splits) delete boot_splits;
 
-    if (!boot_samples.empty()) {
-        aligned_free(boot_samples[0]); // free memory
-        boot_samples.clear();
-    }
+    boot_samples.clear();
+    deleteNNIWorkers();
+    deleteTreeWorkers();
 }
 
 extern const char *aa_model_names_rax[];
@@ -806,6 +851,11 @@ void IQTree::initCandidateTreeSet(int nParTrees, int nNNITrees) {
         cout << "Computing log-likelihood of " << initTreeStrings.size() - init_size << " initial trees ... ";
     startTime = getRealTime();
 
+    DoubleVector initTreeScores;
+    if (evaluateTreesParallel(initTreeStrings, initTreeScores, params->init_workers, init_size, false)) {
+        for (int i = 0; i < initTreeStrings.size(); i++)
+            candidateTrees.update(initTreeStrings[i], initTreeScores[i]);
+    } else
     for (vector<string>::iterator it = initTreeStrings.begin(); it != initTreeStrings.end(); ++it) {
         string treeString;
         double score;
@@ -847,6 +897,17 @@ void IQTree::initCandidateTreeSet(int nParTrees, int nNNITrees) {
     candidateTrees.setMaxSize(Params::getInstance().numSupportTrees);
     vector<string>::iterator it;
 
+    DoubleVector bestInitScores;
+    if (evaluateTreesParallel(bestInitTrees, bestInitScores, params->init_workers, bestInitTrees.size(), true)) {
+        for (int i = 0; i < bestInitTrees.size(); i++) {
+            addTreeToCandidateSet(bestInitTrees[i], bestInitScores[i], true, MPIHelper::getInstance().getProcessID());
+            if (Params::getInstance().writeDistImdTrees)
+                intermediateTrees.update(bestInitTrees[i], bestInitScores[i]);
+        }
+        // leave the last tree as current tree like the sequential search
+        readTreeString(bestInitTrees.back());
+        setCurScore(bestInitScores.back());
+    } else
     for (it = bestInitTrees.begin(); it != bestInitTrees.end(); it++) {
         readTreeString(*it);
 //        optimizeBranches();
@@ -858,6 +919,9 @@ void IQTree::initCandidateTreeSet(int nParTrees, int nNNITrees) {
             intermediateTrees.update(treeString, curScore);
     }
 
+    // the worker trees are not needed during the tree search
+    deleteTreeWorkers();
+
     // TODO turning this
     if (isMixlen()) {
         cout << "Optimizing model parameters for top " << min((int)candidateTrees.size(), params->popSize) << " candidate trees... " << endl;
@@ -2201,6 +2265,14 @@ double IQTree::doTreeSearch() {
         cout << "--------------------------------------------------------------------" << endl;
     }
 
+    // tree search with single-precision partial likelihoods, final steps are done in double
+    if (params->lk_float) {
+        if (setLikelihoodFloat(true))
+            cout << "Tree search with single-precision partial likelihoods" << endl;
+        else
+            cout << "NOTE: Single-precision partial likelihoods not supported for this model, using double precision" << endl;
+    }
+
     double initCPUTime = getRealTime();
     int treesPerProc = (params->numInitTrees) / MPIHelper::getInstance().getNumProcesses() - candidateTrees.size();
     if (params->numInitTrees % MPIHelper::getInstance().getNumProcesses() != 0) {
@@ -2302,20 +2374,27 @@ double IQTree::doTreeSearch() {
         Alignment *saved_aln = aln;
 
         string curTree;
-        /*----------------------------------------
-         * Perturb the tree
-         *---------------------------------------*/
-        doTreePerturbation();
-
-        /*----------------------------------------
-         * Optimize tree with NNI
-         *----------------------------------------*/
-        pair<int, int> nniInfos; // <num_NNIs, num_steps>
-        nniInfos = doNNISearch();
-        curTree = getTreeString();
-        int pos = addTreeToCandidateSet(curTree, curScore, true, MPIHelper::getInstance().getProcessID());
-        if (pos != -2 && pos != -1 && (Params::getInstance().fixStableSplits || Params::getInstance().adaptPertubation))
-            candidateTrees.computeSplitOccurences(Params::getInstance().stableSplitThreshold);
+        if (!doParallelWalkers(cur_correlation)) {
+            /*----------------------------------------
+             * Perturb the tree
+             *---------------------------------------*/
+            doTreePerturbation();
+
+            /*----------------------------------------
+             * Optimize tree with NNI
+             *----------------------------------------*/
+            pair<int, int> nniInfos; // <num_NNIs, num_steps>
+            nniInfos = doNNISearch();
+            if (params->lk_float && isLikelihoodFloatUnderflown()) {
+                outWarning("Numerical underflow of single-precision partial likelihoods, switching back to double precision");
+                setLikelihoodFloat(false);
+                curScore = computeLikelihood();
+            }
+            curTree = getTreeString();
+            int pos = addTreeToCandidateSet(curTree, curScore, true, MPIHelper::getInstance().getProcessID());
+            if (pos != -2 && pos != -1 && (Params::getInstance().fixStableSplits || Params::getInstance().adaptPertubation))
+                candidateTrees.computeSplitOccurences(Params::getInstance().stableSplitThreshold);
+        }
 
         if (MPIHelper::getInstance().isWorker() || MPIHelper::getInstance().gotMessage())
             syncCurrentTree();
@@ -2414,9 +2493,14 @@ double IQTree::doTreeSearch() {
     
     if(params->ufboot2corr) refineBootTrees();
 
+    // release the walkers of doParallelWalkers()
+    deleteTreeWorkers();
+
     if (!early_stop)
         sendStopMessage();
 
+    // the best tree is re-evaluated in double precision
+    setLikelihoodFloat(false);
     readTreeString(candidateTrees.getBestTreeStrings()[0]);
 
     if (testNNI)
@@ -2447,6 +2531,45 @@ double IQTree::doTreeSearch() {
 
 }
 
+double IQTree::doWarmBootTreeSearch(const string &start_tree, int unsuccess_iterations) {
+    // like refineBootTrees(), the model parameters of start_tree are kept
+    bool saved_on_refine_btree = on_refine_btree;
+    on_refine_btree = true;
+    // the alignment may have changed since the last search
+    ptn_freq_computed = false;
+
+    candidateTrees.clear();
+    candidateTrees.setMaxSize(params->popSize);
+
+    readTreeString(start_tree);
+    initializeAllPartialLh();
+    clearAllPartialLH();
+    // branch lengths of the start tree are close already
+    optimizeBranches(2);
+    doNNISearch();
+    candidateTrees.update(getTreeString(), curScore);
+
+    int iteration = 0, last_improved = 0;
+    while (iteration - last_improved < unsuccess_iterations) {
+        iteration++;
+        readTreeString(candidateTrees.getRandTopTree(params->popSize));
+        doRandomNNIs();
+        doNNISearch();
+        double best_score = candidateTrees.getBestScore();
+        candidateTrees.update(getTreeString(), curScore);
+        if (curScore > best_score + params->loglh_epsilon)
+            last_improved = iteration;
+    }
+    if (verbose_mode >= VB_MED)
+        cout << "Reduced search stopped after " << iteration << " iterations" << endl;
+
+    readTreeString(candidateTrees.getBestTreeStrings(1)[0]);
+    initializeAllPartialLh();
+    curScore = computeLogL();
+    on_refine_btree = saved_on_refine_btree;
+    return curScore;
+}
+
 
 /*
 void IQTree::refineBootTrees(){
@@ -2591,7 +2714,7 @@ void IQTree::refineBootTrees(){
         stringstream ostr;
         printTree(ostr, WT_TAXON_ID | WT_SORT_TAXA);
         tree = ostr.str();
-        boot_trees[sample] = getTreeString();
+        boot_trees.setTree(sample, getTreeString(), rooted);
         boot_logl[sample] = curScore;
 
         printTree(btreea, WT_NEWLINE | WT_SORT_TAXA);
@@ -2783,7 +2906,7 @@ void IQTree::refineBootTrees() {
             boot_tree->printTree(ostr, WT_TAXON_ID | WT_SORT_TAXA | WT_BR_LEN | WT_BR_LEN_SHORT);
         else
             boot_tree->printTree(ostr, WT_TAXON_ID | WT_SORT_TAXA);
-        boot_trees[sample] = ostr.str();
+        boot_trees.setTree(sample, ostr.str(), rooted);
         boot_logl[sample] = boot_tree->curScore;
 
 
@@ -2990,6 +3113,9 @@ pair<int, int> IQTree::doNNISearch(bool write_info) {
             }
         }
     }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
     MPIHelper::getInstance().setNumNNISearch(MPIHelper::getInstance().getNumNNISearch() + 1);
 
     return nniInfos;
@@ -3020,6 +3146,8 @@ pair<int, int> IQTree::optimizeNNI(bool speedNNI) {
 
 //        cout << "numSteps = " << numSteps << endl;
         double oldScore = curScore;
+        size_t step_computed, step_reused;
+        getPartialLhCounters(step_computed, step_reused);
         if (save_all_trees == 2) {
             saveCurrentTree(curScore); // BQM: for new bootstrap
         }
@@ -3115,8 +3243,11 @@ pair<int, int> IQTree::optimizeNNI(bool speedNNI) {
             if (appliedNNIs.size() > 1) {
                 // revert all applied NNIs
                 doNNIs(appliedNNIs);
+                // only partial likelihoods below restored branch lengths become invalid
+                DoubleVector optlenvec;
+                saveBranchLengths(optlenvec);
                 restoreBranchLengths(lenvec);
-                clearAllPartialLH();
+                clearChangedPartialLh(optlenvec);
                 // only do the best NNI
                 appliedNNIs.resize(1);
                 doNNIs(appliedNNIs);
@@ -3129,6 +3260,16 @@ pair<int, int> IQTree::optimizeNNI(bool speedNNI) {
             totalNNIApplied += appliedNNIs.size();
         }
 
+        if (verbose_mode >= VB_MED) {
+            size_t computed, reused;
+            getPartialLhCounters(computed, reused);
+            hideProgress();
+            cout << "NNI step " << numSteps << ": " << appliedNNIs.size() << " NNIs applied, "
+                 << computed - step_computed << " partial likelihood vectors recomputed, "
+                 << reused - step_reused << " reused" << endl;
+            showProgress();
+        }
+
         if(curScore < oldScore - params->loglh_epsilon){
             hideProgress();
             cout << "$$$$$$$$: " << curScore << "\t" << oldScore << "\t" << curScore - oldScore << endl;
@@ -3264,17 +3405,14 @@ void IQTree::pllInitUFBootData(){
 //            memset(pllUFBootDataPtr->treels_ptnlh, 0, max_candidate_trees * (sizeof(double *)));
 
             // aln->createBootstrapAlignment() must be called before this fragment
-            pllUFBootDataPtr->boot_samples =
-                (int **) malloc(params->gbo_replicates * sizeof(int *));
-            if(!pllUFBootDataPtr->boot_samples) outError("Not enough dynamic memory!");
+            // same compact counts, permuted into PLL pattern order
+            pllUFBootDataPtr->boot_samples = new BootSamples;
+            pllUFBootDataPtr->boot_samples->init(params->gbo_replicates, pllAlignment->sequenceLength, pllAlignment->sequenceLength);
+            IntVector this_sample(pllAlignment->sequenceLength);
             for(int i = 0; i < params->gbo_replicates; i++){
-                pllUFBootDataPtr->boot_samples[i] =
-                    (int *) malloc(pllAlignment->sequenceLength * sizeof(int));
-                if(!pllUFBootDataPtr->boot_samples[i]) outError("Not enough dynamic memory!");
-                for(int j = 0; j < pllAlignment->sequenceLength; j++){
-                    pllUFBootDataPtr->boot_samples[i][j] =
-                        boot_samples[i][pll2iqtree_pattern_index[j]];
-                }
+                for(int j = 0; j < pllAlignment->sequenceLength; j++)
+                    this_sample[j] = boot_samples.getCount(i, pll2iqtree_pattern_index[j]);
+                pllUFBootDataPtr->boot_samples->setSample(i, this_sample);
             }
 
 
@@ -3316,9 +3454,7 @@ void IQTree::pllDestroyUFBootData(){
                 free(pllUFBootDataPtr->treels_ptnlh[i]);
         free(pllUFBootDataPtr->treels_ptnlh);
 
-        for(int i = 0; i < params->gbo_replicates; i++)
-            free(pllUFBootDataPtr->boot_samples[i]);
-        free(pllUFBootDataPtr->boot_samples);
+        delete pllUFBootDataPtr->boot_samples;
 
         free(pllUFBootDataPtr->boot_logl);
 
@@ -3424,6 +3560,14 @@ void IQTree::setDelete(int _delete) {
 }
 
 void IQTree::evaluateNNIs(Branches &nniBranches, vector<NNIMove>  &positiveNNIs) {
+    if (evaluateNNIsParallel(nniBranches, positiveNNIs)) {
+        // synchronize tree during optimization step
+        if (MPIHelper::getInstance().isMaster() && candidateset_changed.size() > 0
+            && MPIHelper::getInstance().gotMessage()) {
+            syncCurrentTree();
+        }
+        return;
+    }
     for (Branches::iterator it = nniBranches.begin(); it != nniBranches.end(); it++) {
         NNIMove nni = getBestNNIForBran((PhyloNode*) it->second.first, (PhyloNode*) it->second.second, NULL);
         if (nni.newloglh > curScore) {
@@ -3438,6 +3582,296 @@ void IQTree::evaluateNNIs(Branches &nniBranches, vector<NNIMove>  &positiveNNIs)
     }
 }
 
+bool IQTree::evaluateNNIsParallel(Branches &nniBranches, vector<NNIMove> &positiveNNIs) {
+#ifdef _OPENMP
+    // the workers run on the likelihood threads of this tree
+    int num_workers = min(params->nni_workers, num_threads);
+    if (num_workers < 2 || nniBranches.size() < 2 || omp_in_parallel())
+        return false;
+    // NNI moves on these trees depend on more than one PhyloTree object
+    if (isSuperTree() || isMixlen() || !model->useRevKernel() || model->isSiteSpecificModel()
+        || !constraintTree.empty() || save_all_trees == 2 || params->lh_mem_save == LM_MEM_SAVE)
+        return false;
+
+    if (!nni_worker_trees.empty() && nni_worker_trees[0]->aln != aln)
+        deleteNNIWorkers();
+    while (nni_worker_trees.size() < num_workers) {
+        PhyloTree *worker = new PhyloTree;
+        worker->setParams(params);
+        initNNIWorker(worker);
+        nni_worker_trees.push_back(worker);
+    }
+
+    vector<NodeVector> node_maps(num_workers), back_maps(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        if (syncNNIWorker(nni_worker_trees[i], node_maps[i], back_maps[i]))
+            continue;
+        // the node degrees changed, e.g. a new multifurcating tree was read in
+        initNNIWorker(nni_worker_trees[i]);
+        bool synced = syncNNIWorker(nni_worker_trees[i], node_maps[i], back_maps[i]);
+        ASSERT(synced);
+    }
+
+    vector<Branch> branches;
+    for (Branches::iterator it = nniBranches.begin(); it != nniBranches.end(); it++)
+        branches.push_back(it->second);
+    vector<NNIMove> moves(branches.size());
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_workers)
+    for (int i = 0; i < branches.size(); i++) {
+        int thread_id = omp_get_thread_num();
+        PhyloTree *worker = nni_worker_trees[thread_id];
+        NodeVector &node_map = node_maps[thread_id];
+        NodeVector &back_map = back_maps[thread_id];
+        NNIMove nni = worker->getBestNNIForBran((PhyloNode*)node_map[branches[i].first->id],
+                                                (PhyloNode*)node_map[branches[i].second->id], NULL);
+        // translate the move back to this tree, neighbors are in the same order
+        PhyloNode *node1 = (PhyloNode*)back_map[nni.node1->id];
+        PhyloNode *node2 = (PhyloNode*)back_map[nni.node2->id];
+        nni.node1Nei_it = node1->neighbors.begin() + (nni.node1Nei_it - nni.node1->neighbors.begin());
+        nni.node2Nei_it = node2->neighbors.begin() + (nni.node2Nei_it - nni.node2->neighbors.begin());
+        nni.node1 = node1;
+        nni.node2 = node2;
+        moves[i] = nni;
+    }
+
+    // merge in branch order, so that the result does not depend on the thread schedule
+    for (int i = 0; i < moves.size(); i++)
+        if (moves[i].newloglh > curScore)
+            positiveNNIs.push_back(moves[i]);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IQTree::initNNIWorker(PhyloTree *worker) {
+    worker->copyPhyloTree(this, true);
+    NodeVector node_map(nodeNum, NULL), back_map(worker->nodeNum, NULL);
+    Node *worker_root = worker->findLeafName(root->name);
+    ASSERT(worker_root);
+    mapNNIWorkerNodes(root, NULL, worker_root, NULL, node_map, back_map);
+    // syncNNIWorker() matches the nodes by id
+    for (int id = 0; id < nodeNum; id++) {
+        ASSERT(node_map[id]);
+        node_map[id]->id = id;
+    }
+
+    worker->setModelFactory(NULL);
+    worker->sse = sse;
+    worker->setNumThreads(1);
+    worker->setModelFactory(getModelFactory());
+    worker->initializeAllPartialLh();
+    worker->computePtnFreq();
+}
+
+/**
+    @param[out] nodes all nodes of the tree, indexed by node id
+ */
+static void getNodesById(Node *node, Node *dad, NodeVector &nodes) {
+    ASSERT(node->id >= 0 && node->id < nodes.size() && !nodes[node->id]);
+    nodes[node->id] = node;
+    FOR_NEIGHBOR_IT(node, dad, it)
+        getNodesById((*it)->node, node, nodes);
+}
+
+bool IQTree::syncNNIWorker(PhyloTree *worker, NodeVector &node_map, NodeVector &back_map) {
+    if (worker->nodeNum != nodeNum)
+        return false;
+    node_map.assign(nodeNum, NULL);
+    back_map.assign(nodeNum, NULL);
+    getNodesById(root, NULL, back_map);
+    getNodesById(worker->root, NULL, node_map);
+    for (int id = 0; id < nodeNum; id++)
+        if (back_map[id]->degree() != node_map[id]->degree())
+            return false;
+
+    // link the worker neighbors like the neighbors of this tree, which then have the same order
+    for (int id = 0; id < nodeNum; id++) {
+        Node *node = back_map[id];
+        Node *worker_node = node_map[id];
+        for (int i = 0; i < node->neighbors.size(); i++) {
+            PhyloNeighbor *nei = (PhyloNeighbor*)node->neighbors[i];
+            PhyloNeighbor *worker_nei = (PhyloNeighbor*)worker_node->neighbors[i];
+            worker_nei->node = node_map[nei->node->id];
+            worker_nei->setLength(nei);
+            worker_nei->id = nei->id;
+            worker_nei->size = nei->size;
+            worker_nei->direction = nei->direction;
+        }
+    }
+    worker->root = node_map[root->id];
+    // hand out the allocated partial likelihood memory again for the new topology
+    worker->initializeAllPartialLh();
+    // this tree may have rebuilt its alignment summary since the last round
+    worker->borrowSummary(this);
+
+    // the invariant site likelihoods depend on the model parameters
+    size_t nptn = get_safe_upper_limit(getAlnNPattern()) + max(get_safe_upper_limit(aln->num_states),
+        get_safe_upper_limit(model_factory->unobserved_ptns.size()));
+    memcpy(worker->ptn_invar, ptn_invar, nptn*sizeof(double));
+    worker->setCurScore(curScore);
+    return true;
+}
+
+void IQTree::mapNNIWorkerNodes(Node *node, Node *dad, Node *worker_node, Node *worker_dad,
+                               NodeVector &node_map, NodeVector &back_map) {
+    ASSERT(node->id < node_map.size() && worker_node->id < back_map.size());
+    ASSERT(node->degree() == worker_node->degree());
+    ASSERT(!node->isLeaf() || node->name == worker_node->name);
+    node_map[node->id] = worker_node;
+    back_map[worker_node->id] = node;
+
+    // children come out of the newick copy in the same order, only the dad may have moved
+    NeighborVec children;
+    FOR_NEIGHBOR_IT(worker_node, worker_dad, it)
+        children.push_back(*it);
+    NeighborVec::iterator child = children.begin();
+    NeighborVec ordered;
+    FOR_NEIGHBOR_IT(node, NULL, it) {
+        if ((*it)->node == dad) {
+            ordered.push_back(worker_node->findNeighbor(worker_dad));
+            continue;
+        }
+        Neighbor *worker_nei = *child++;
+        ordered.push_back(worker_nei);
+        worker_nei->setLength(*it);
+        worker_nei->node->findNeighbor(worker_node)->setLength(*it);
+        mapNNIWorkerNodes((*it)->node, node, worker_nei->node, worker_node, node_map, back_map);
+    }
+    worker_node->neighbors = ordered;
+}
+
+void IQTree::deleteNNIWorkers() {
+    for (vector<PhyloTree*>::reverse_iterator it = nni_worker_trees.rbegin(); it != nni_worker_trees.rend(); it++) {
+        // model is shared with this tree
+        (*it)->setModelFactory(NULL);
+        delete (*it);
+    }
+    nni_worker_trees.clear();
+}
+
+bool IQTree::evaluateTreesParallel(StrVector &trees, DoubleVector &scores, int num_workers, int first_brlen, bool nni_search) {
+#ifdef _OPENMP
+    num_workers = min(num_workers, (int)trees.size());
+    if (num_workers < 2 || omp_in_parallel() || !canUseTreeWorkers())
+        return false;
+
+    if (!tree_workers.empty() && tree_workers[0]->aln != aln)
+        deleteTreeWorkers();
+    while (tree_workers.size() < num_workers) {
+        IQTree *worker = new IQTree;
+        worker->setParams(params);
+        worker->copyPhyloTree(this, true);
+        if (!constraintTree.empty())
+            worker->constraintTree.readConstraint(constraintTree);
+        worker->initSettings(*params);
+        // the model is shared, see refineBootTrees()
+        worker->on_refine_btree = true;
+        worker->sse = sse;
+        worker->setNumThreads(1);
+        worker->setModelFactory(getModelFactory());
+        tree_workers.push_back(worker);
+    }
+
+    scores.resize(trees.size());
+    // the workers would report their progress all at once
+    bool saved_progress_display = progress_display::getProgressDisplay();
+    progress_display::setProgressDisplay(false);
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_workers)
+    for (int i = 0; i < trees.size(); i++) {
+        IQTree *worker = tree_workers[omp_get_thread_num()];
+        worker->readTreeString(trees[i]);
+        worker->initializeAllPartialLh();
+        if (nni_search)
+            worker->doNNISearch();
+        else if (i >= first_brlen)
+            worker->optimizeBranches(params->brlen_num_traversal);
+        else
+            worker->computeLogL();
+        trees[i] = worker->getTreeString();
+        scores[i] = worker->getCurScore();
+    }
+
+    progress_display::setProgressDisplay(saved_progress_display);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IQTree::canUseTreeWorkers() {
+    // the search on these trees depends on more than one tree object or writes per-tree output
+    return !(isSuperTree() || isMixlen() || !model->useRevKernel() || model->isSiteSpecificModel()
+        || save_all_trees == 2 || params->pll || params->lk_float
+        || params->write_intermediate_trees || params->writeDistImdTrees);
+}
+
+bool IQTree::doParallelWalkers(double cur_correlation) {
+#ifdef _OPENMP
+    int num_walkers = params->search_walkers;
+    if (num_walkers < 2 || iqp_assess_quartet == IQP_BOOTSTRAP || omp_in_parallel() || !canUseTreeWorkers())
+        return false;
+
+    // perturb in turn, so that the walkers draw from the same candidate set
+    // and the random number stream does not depend on the thread schedule
+    StrVector trees;
+    for (int walker = 0; walker < num_walkers; walker++) {
+        doTreePerturbation();
+        trees.push_back(getTreeString());
+    }
+
+    DoubleVector scores;
+    if (!evaluateTreesParallel(trees, scores, num_walkers, trees.size(), true))
+        return false;
+
+    int processID = MPIHelper::getInstance().getProcessID();
+    double best_score = candidateTrees.getBestScore();
+    int best_walker = -1, last_walker = 0;
+    for (int walker = 0; walker < trees.size(); walker++) {
+        // stop where the sequential search would have stopped
+        if (walker > 0 && stop_rule.meetStopCondition(stop_rule.getCurIt(), cur_correlation))
+            break;
+        last_walker = walker;
+        int pos = addTreeToCandidateSet(trees[walker], scores[walker], true, processID);
+        if (pos != -2 && pos != -1 && (Params::getInstance().fixStableSplits || Params::getInstance().adaptPertubation))
+            candidateTrees.computeSplitOccurences(Params::getInstance().stableSplitThreshold);
+        if (scores[walker] > best_score + params->modelEps) {
+            best_score = scores[walker];
+            best_walker = walker;
+        }
+    }
+
+    if (best_walker < 0) {
+        readTreeString(trees[last_walker]);
+        setCurScore(scores[last_walker]);
+        return true;
+    }
+
+    // re-optimize model parameters on the best new tree like doNNISearch()
+    readTreeString(trees[best_walker]);
+    computeLogL();
+    optimizeModelParameters(false, params->modelEps * 10);
+    getModelFactory()->saveCheckpoint();
+    if (rooted && params->root_move_dist > 0)
+        optimizeRootPosition(params->root_move_dist, true, params->modelEps * 10);
+    addTreeToCandidateSet(getTreeString(), curScore, false, processID);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IQTree::deleteTreeWorkers() {
+    for (vector<IQTree*>::reverse_iterator it = tree_workers.rbegin(); it != tree_workers.rend(); it++) {
+        // model is shared with this tree
+        (*it)->setModelFactory(NULL);
+        delete (*it);
+    }
+    tree_workers.clear();
+}
+
 //Branches IQTree::getReducedListOfNNIBranches(Branches &previousNNIBranches) {
 //    Branches resBranches;
 //    for (Branches::iterator it = previousNNIBranches.begin(); it != previousNNIBranches.end(); it++) {
@@ -3594,27 +4028,38 @@ void IQTree::saveCurrentTree(double cur_logl) {
             printTree(ostr, WT_TAXON_ID + WT_SORT_TAXA);
         tree_str = ostr.str();
 
+        size_t boot_stride = boot_samples.getStride();
+        BootCountType boot_count_type = boot_samples.getCountType();
+        // replicates whose best tree becomes the current tree
+        vector<char> boot_updated(sample_end - sample_start, 0);
+
     #ifdef _OPENMP
         int rand_seed = random_int(1000);
         #pragma omp parallel
         {
         int *rstream;
         init_random(rand_seed + omp_get_thread_num(), false, &rstream);
-        #pragma omp for
+        #pragma omp for schedule(dynamic)
     #else
         int *rstream = randstream;
     #endif
-        for (int sample = sample_start; sample < sample_end; sample++) {
-            double rell = 0.0;
-
-            {
-                // SSE optimized version of the above loop
-                BootValType *boot_sample = boot_samples[sample];
-
-                BootValType res = (this->*dotProduct)(pattern_lh, boot_sample, nptn);
-
-                rell = res;
-            }
+        for (int block = sample_start; block < sample_end; block += BOOT_SAMPLE_BLOCK) {
+        // RELL scores of a block of replicates, reading pattern_lh once per tile
+        int block_end = min(block + BOOT_SAMPLE_BLOCK, sample_end);
+        double block_rell[BOOT_SAMPLE_BLOCK];
+        switch (boot_count_type) {
+        case BOOT_COUNT_UINT8:
+            (this->*dotProductBatchUInt8)(pattern_lh, (uint8_t*)boot_samples.getRow(block), boot_stride, block_end - block, nptn, block_rell);
+            break;
+        case BOOT_COUNT_UINT16:
+            (this->*dotProductBatchUInt16)(pattern_lh, (uint16_t*)boot_samples.getRow(block), boot_stride, block_end - block, nptn, block_rell);
+            break;
+        default:
+            (this->*dotProductBatch)(pattern_lh, (float*)boot_samples.getRow(block), boot_stride, block_end - block, nptn, block_rell);
+            break;
+        }
+        for (int sample = block; sample < block_end; sample++) {
+            double rell = block_rell[sample - block];
 
             bool better = rell > boot_logl[sample] + params->ufboot_epsilon;
             if (!better && rell > boot_logl[sample] - params->ufboot_epsilon) {
@@ -3628,13 +4073,24 @@ void IQTree::saveCurrentTree(double cur_logl) {
                 }
                 boot_logl[sample] = max(boot_logl[sample], rell);
                 boot_orig_logl[sample] = cur_logl;
-                boot_trees[sample] = tree_str;
+                boot_updated[sample - sample_start] = 1;
             }
         }
+        }
     #ifdef _OPENMP
         finish_random(rstream);
         }
     #endif
+        // intern the current tree once for all updated replicates
+        int tree_id = -1;
+        for (int sample = sample_start; sample < sample_end; sample++)
+            if (boot_updated[sample - sample_start]) {
+                if (tree_id < 0)
+                    tree_id = boot_trees.addTree(tree_str, rooted);
+                boot_trees.setTreeID(sample, tree_id);
+            }
+        if (tree_id >= 0)
+            boot_trees.updateSplitCounts();
     }
     if (Params::getInstance().print_tree_lh) {
         out_treelh << cur_logl;
@@ -3712,11 +4168,15 @@ void IQTree::summarizeBootstrap(Params &params, MTreeSet &trees) {
      trees.convertSplits(taxname, sg, hash_ss, SW_COUNT, -1, false);
      */
     trees.convertSplits(taxname, sg, hash_ss, SW_COUNT, -1, NULL, false); // do not sort taxa
+    assignBootstrapSupport(params, sg, hash_ss, taxname, sum_weights, trees);
+}
 
+void IQTree::assignBootstrapSupport(Params &params, SplitGraph &sg, SplitIntMap &hash_ss, vector<string> &taxname,
+                                    int sum_weights, MTreeSet &trees) {
     if (verbose_mode >= VB_MED)
     	cout << sg.size() << " splits found" << endl;
 
-    sg.scaleWeight(1.0 / trees.sumTreeWeights(), false, 4);
+    sg.scaleWeight(1.0 / sum_weights, false, 4);
     string out_file;
     out_file = params.out_prefix;
     out_file += ".splits";
@@ -3791,7 +4251,22 @@ void IQTree::writeUFBootTrees(Params &params) {
     filename += ".ufboot";
     ofstream out(filename.c_str());
 
-    trees.init(boot_trees, rooted);
+    // parse every distinct tree only once
+    StrVector distinct_trees;
+    IntVector sample_trees(boot_trees.size(), -1);
+    map<int, int> tree_index;
+    for (i = 0; i < boot_trees.size(); i++) {
+        int tree_id = boot_trees.getTreeID(i);
+        if (tree_id < 0)
+            continue;
+        map<int, int>::iterator it = tree_index.find(tree_id);
+        if (it == tree_index.end()) {
+            it = tree_index.insert(make_pair(tree_id, (int)distinct_trees.size())).first;
+            distinct_trees.push_back(boot_trees[i]);
+        }
+        sample_trees[i] = it->second;
+    }
+    trees.init(distinct_trees, rooted);
     for (i = 0; i < trees.size(); i++) {
         NodeVector taxa;
         // change the taxa name from ID to real name
@@ -3802,12 +4277,15 @@ void IQTree::writeUFBootTrees(Params &params) {
             // reinsert removed seqs into each tree
             trees[i]->insertTaxa(removed_seqs, twin_seqs);
         }
-        // now print to file
-        for (j = 0; j < trees.tree_weights[i]; j++)
-            if (params.print_ufboot_trees == 1)
-                trees[i]->printTree(out, WT_NEWLINE);
-            else
-                trees[i]->printTree(out, WT_NEWLINE + WT_BR_LEN);
+    }
+    // now print to file in the order of replicates
+    for (i = 0; i < sample_trees.size(); i++) {
+        if (sample_trees[i] < 0)
+            continue;
+        if (params.print_ufboot_trees == 1)
+            trees[sample_trees[i]]->printTree(out, WT_NEWLINE);
+        else
+            trees[sample_trees[i]]->printTree(out, WT_NEWLINE + WT_BR_LEN);
     }
     cout << "UFBoot trees printed to " << filename << endl;
     out.close();
@@ -3815,27 +4293,35 @@ void IQTree::writeUFBootTrees(Params &params) {
 
 void IQTree::summarizeBootstrap(Params &params) {
     setRootNode(params.root);
+    // split counts are kept up-to-date by boot_trees, no tree has to be parsed
+    SplitGraph sg;
+    SplitIntMap hash_ss;
+    vector<string> taxname;
+    taxname.resize(leafNum);
+    if (boot_splits.empty()) {
+        getTaxaName(taxname);
+    } else {
+        boot_splits.back()->getTaxaName(taxname);
+    }
+    boot_trees.convertSplits(taxname, sg, hash_ss);
+    if (verbose_mode >= VB_MED)
+        cout << boot_trees.getNumTrees() << " distinct UFBoot trees" << endl;
+    int sum_weights = 0;
+    for (int sample = 0; sample < boot_trees.size(); sample++)
+        if (boot_trees.getTreeID(sample) >= 0)
+            sum_weights++;
+    // trees are only used to report trees disagreeing with INFO nodes
     MTreeSet trees;
-    trees.init(boot_trees, rooted);
-    summarizeBootstrap(params, trees);
+    assignBootstrapSupport(params, sg, hash_ss, taxname, sum_weights, trees);
 }
 
 void IQTree::summarizeBootstrap(SplitGraph &sg) {
-    MTreeSet trees;
-    //SplitGraph sg;
-    trees.init(boot_trees, rooted);
     SplitIntMap hash_ss;
     // make the taxa name
     vector<string> taxname;
     taxname.resize(leafNum);
     getTaxaName(taxname);
-
-    /*if (!tree.save_all_trees)
-     trees.convertSplits(taxname, sg, hash_ss, SW_COUNT, -1);
-     else
-     trees.convertSplits(taxname, sg, hash_ss, SW_COUNT, -1, false);
-     */
-    trees.convertSplits(taxname, sg, hash_ss, SW_COUNT, -1, NULL, false); // do not sort taxa
+    boot_trees.convertSplits(taxname, sg, hash_ss);
 }
 
 void IQTree::computeRootstrap(MTreeSet &trees, bool use_taxid) {
@@ -4132,9 +4618,10 @@ void IQTree::pllConvertUFBootData2IQTree(){
 //        treels_logl.push_back(pllUFBootDataPtr->treels_logl[i]);
 
     //boot_trees
-    boot_trees.clear();
+    boot_trees.init(params->gbo_replicates);
     for(int i = 0; i < params->gbo_replicates; i++)
-        boot_trees.push_back(pllUFBootDataPtr->boot_trees[i]);
+        boot_trees.setTree(i, pllUFBootDataPtr->boot_trees[i], rooted);
+    boot_trees.updateSplitCounts();
 
 }
 
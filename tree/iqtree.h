@@ -32,6 +32,8 @@
 #include "mtreeset.h"
 #include "node.h"
 #include "candidateset.h"
+#include "bootsamples.h"
+#include "boottrees.h"
 #include "utils/pllnni.h"
 
 typedef std::map< string, double > mapString2Double;
@@ -317,6 +319,18 @@ public:
      */
     virtual double doTreeSearch();
 
+    /**
+            reduced tree search of a standard bootstrap replicate (--boot-warm) on the
+            current alignment: the search starts from start_tree, keeps the model
+            parameters fixed and stops after unsuccess_iterations perturbation
+            iterations without a better tree. Partial likelihood buffers already
+            allocated are reused, so they must be large enough for the alignment.
+            @param start_tree starting tree with taxon IDs, e.g. the ML tree
+            @param unsuccess_iterations number of unsuccessful iterations to stop
+            @return log-likelihood of the best tree found, which becomes the current tree
+     */
+    double doWarmBootTreeSearch(const string &start_tree, int unsuccess_iterations);
+
     /**
      *  Wrapper function that uses either PLL or IQ-TREE to optimize the branch length
      *  @param maxTraversal
@@ -771,8 +785,8 @@ public:
     /** log-likelihood threshold (l_min) */
     double logl_cutoff;
 
-    /** vector of bootstrap alignments generated */
-    vector<BootValType* > boot_samples;
+    /** pattern counts of the bootstrap alignments generated */
+    BootSamples boot_samples;
 
     /** starting sample for UFBoot, used for MPI */
     int sample_start;
@@ -780,8 +794,8 @@ public:
     /** end sample for UFBoot, used for MPI */
     int sample_end;
 
-    /** newick string of corresponding bootstrap trees */
-    StrVector boot_trees;
+    /** best tree of every bootstrap replicate, each distinct tree stored once */
+    BootTrees boot_trees;
 
     /** bootstrap tree strings with branch lengths, for -wbtl option */
 //    StrVector boot_trees_brlen;
@@ -810,6 +824,18 @@ public:
     /** summarize all bootstrap trees */
     void summarizeBootstrap(Params &params, MTreeSet &trees);
 
+    /**
+        assign split supports to the branches of this tree and print split files
+        @param params program parameters
+        @param sg splits of the bootstrap trees, weighted by number of trees
+        @param hash_ss map from the splits in sg to their counts
+        @param taxname taxon names
+        @param sum_weights total number of bootstrap trees
+        @param trees bootstrap trees, only used to report trees disagreeing with INFO nodes
+     */
+    void assignBootstrapSupport(Params &params, SplitGraph &sg, SplitIntMap &hash_ss, vector<string> &taxname,
+                                int sum_weights, MTreeSet &trees);
+
     /** summarize bootstrap trees */
     virtual void summarizeBootstrap(Params &params);
 
@@ -854,6 +880,84 @@ protected:
     bool testNNI;
 
     ofstream outNNI;
+
+    /**** parallel NNI evaluation *****/
+
+    /** worker trees evaluating NNI branches concurrently, one per thread */
+    vector<PhyloTree*> nni_worker_trees;
+
+    /**
+        evaluate NNI branches concurrently on the worker trees (Params::nni_workers)
+        @param nniBranches branches on which NNIs will be evaluated
+        @param[out] positiveNNIs positive NNIs in the order of nniBranches
+        @return FALSE if parallel evaluation does not apply, then nothing was evaluated
+     */
+    bool evaluateNNIsParallel(Branches &nniBranches, vector<NNIMove> &positiveNNIs);
+
+    /**
+        copy the current tree into a worker tree, whose nodes get the ids of this tree,
+        and allocate its partial likelihoods with the model of this tree
+        @param worker worker tree
+     */
+    void initNNIWorker(PhyloTree *worker);
+
+    /**
+        link the worker neighbors like the current tree and copy the branch lengths;
+        the partial likelihood memory of the worker is reused
+        @param worker worker tree set up by initNNIWorker()
+        @param[out] node_map worker node of every node of this tree, indexed by node id
+        @param[out] back_map node of this tree of every worker node, indexed by node id
+        @return FALSE if the node degrees differ from the worker, then initNNIWorker() is needed
+     */
+    bool syncNNIWorker(PhyloTree *worker, NodeVector &node_map, NodeVector &back_map);
+
+    /**
+        match the subtree below node with the same subtree of a worker tree,
+        copy exact branch lengths and bring the worker neighbors into the same order
+     */
+    void mapNNIWorkerNodes(Node *node, Node *dad, Node *worker_node, Node *worker_dad,
+                           NodeVector &node_map, NodeVector &back_map);
+
+    /** delete all NNI worker trees */
+    void deleteNNIWorkers();
+
+    /**** parallel evaluation of whole trees *****/
+
+    /** worker trees evaluating different trees concurrently, one per thread */
+    vector<IQTree*> tree_workers;
+
+    /**
+        compute the log-likelihoods of trees, or optimize them by NNI, concurrently on
+        the tree workers. The workers share the alignment and the model of this tree,
+        whose parameters are not re-estimated meanwhile.
+        @param[in,out] trees tree strings, replaced by the evaluated trees
+        @param[out] scores log-likelihood of every tree
+        @param num_workers number of threads
+        @param first_brlen trees from this index on get their branch lengths optimized
+        @param nni_search TRUE to run doNNISearch() on every tree
+        @return FALSE if parallel evaluation does not apply, then nothing was evaluated
+     */
+    bool evaluateTreesParallel(StrVector &trees, DoubleVector &scores, int num_workers, int first_brlen, bool nni_search);
+
+    /** delete all tree workers */
+    void deleteTreeWorkers();
+
+    /**
+        @return TRUE if trees can be optimized on the tree workers,
+        i.e. the search on a tree only involves this tree object
+     */
+    bool canUseTreeWorkers();
+
+    /**
+        one round of the stochastic search with Params::search_walkers walkers. The perturbed
+        trees are created in turn, optimized by NNI concurrently on the tree workers and added
+        to the candidate set in walker order, as if the walkers had run one after another.
+        The model parameters are re-estimated once per round on the best new tree.
+        @param cur_correlation current bootstrap correlation for the stop rule
+        @return FALSE if parallel walkers do not apply, then nothing was done
+     */
+    bool doParallelWalkers(double cur_correlation);
+
 protected:
 
     //bool print_tree_lh;
@@ -69,6 +69,65 @@ Numeric PhyloTree::dotProductSIMD(Numeric *x, Numeric *y, int size) {
     return horizontal_add(res);
 }
 
+/**
+    load VectorClass::size() bootstrap pattern counts as floating point;
+    integer counts are widened element-wise, the compiler turns this into
+    zero-extension plus int-to-float conversion
+ */
+template <class VectorClass, class Numeric, class Count>
+struct BootCountLoader {
+    static inline VectorClass load(Count *counts) {
+        Numeric buf[VectorClass::size()];
+        for (int j = 0; j < VectorClass::size(); j++)
+            buf[j] = counts[j];
+        return VectorClass().load(buf);
+    }
+};
+
+/** counts already stored as Numeric need no conversion */
+template <class VectorClass, class Numeric>
+struct BootCountLoader<VectorClass, Numeric, Numeric> {
+    static inline VectorClass load(Numeric *counts) {
+        return VectorClass().load_a(counts);
+    }
+};
+
+template <class Numeric, class VectorClass, class Count>
+void PhyloTree::dotProductBatchSIMD(Numeric *x, Count *mat, size_t stride, int nrow, int size, double *res) {
+    typedef BootCountLoader<VectorClass, Numeric, Count> Loader;
+    // 8KB of float (16KB of double) of x per tile
+    const int TILE = 2048;
+    const int VS = VectorClass::size();
+    for (int row = 0; row < nrow; row++)
+        res[row] = 0.0;
+    for (int start = 0; start < size; start += TILE) {
+        int end = min(start + TILE, size);
+        int row;
+        for (row = 0; row+4 <= nrow; row += 4) {
+            Count *m0 = mat + row*stride, *m1 = m0 + stride, *m2 = m1 + stride, *m3 = m2 + stride;
+            VectorClass x_i, sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+            for (int i = start; i < end; i += VS) {
+                x_i.load_a(&x[i]);
+                sum0 = mul_add(x_i, Loader::load(&m0[i]), sum0);
+                sum1 = mul_add(x_i, Loader::load(&m1[i]), sum1);
+                sum2 = mul_add(x_i, Loader::load(&m2[i]), sum2);
+                sum3 = mul_add(x_i, Loader::load(&m3[i]), sum3);
+            }
+            res[row] += horizontal_add(sum0);
+            res[row+1] += horizontal_add(sum1);
+            res[row+2] += horizontal_add(sum2);
+            res[row+3] += horizontal_add(sum3);
+        }
+        for (; row < nrow; row++) {
+            Count *m0 = mat + row*stride;
+            VectorClass sum0 = 0.0;
+            for (int i = start; i < end; i += VS)
+                sum0 = mul_add(VectorClass().load_a(&x[i]), Loader::load(&m0[i]), sum0);
+            res[row] += horizontal_add(sum0);
+        }
+    }
+}
+
 /************************************************************************************************
  *
  *   Highly optimized vectorized versions of likelihood functions
@@ -1438,6 +1497,18 @@ inline UINT fast_popcount(Vec8ui &x) {
 
 }
 
+#ifdef VECTORI512_H
+inline UINT fast_popcount(Vec16ui &x) {
+#ifdef __AVX512VPOPCNTDQ__
+    // count all 512 bits with one VPOPCNTQ
+    return (UINT)_mm512_reduce_add_epi64(_mm512_popcnt_epi64(x));
+#else
+    Vec8ui low = x.get_low(), high = x.get_high();
+    return fast_popcount(low) + fast_popcount(high);
+#endif
+}
+#endif
+
 inline void horizontal_popcount(Vec4ui &x) {
     MEM_ALIGN_BEGIN UINT vec[4] MEM_ALIGN_END;
     x.store_a(vec);
@@ -1815,6 +1886,89 @@ int PhyloTree::computeParsimonyBranchFastSIMD(PhyloNeighbor *dad_branch, PhyloNo
     return score;
 }
 
+template<class VectorClass>
+UINT PhyloTree::computeParsimonyInsertCostFastSIMD(UINT *node_pars, UINT *dad_pars, UINT *subtree_pars, UINT lower_bound) {
+    int nstates = aln->getMaxNumStates();
+    const int NUM_BITS = VectorClass::size() * UINT_BITS;
+    int nsites = (aln->num_parsimony_sites + NUM_BITS - 1)/NUM_BITS;
+    int entry_size = nstates * VectorClass::size();
+    UINT score = 0;
+
+    // the score of the tree without the subtree is the same for all branches, so only
+    // the substitutions between the branch state sets and the subtree are counted
+    switch (nstates) {
+    case 4:
+        for (int site = 0; site < nsites; site++) {
+            size_t offset = entry_size*site;
+            VectorClass *x = (VectorClass*)(node_pars + offset);
+            VectorClass *y = (VectorClass*)(dad_pars + offset);
+            VectorClass *t = (VectorClass*)(subtree_pars + offset);
+            VectorClass z0 = x[0] & y[0];
+            VectorClass z1 = x[1] & y[1];
+            VectorClass z2 = x[2] & y[2];
+            VectorClass z3 = x[3] & y[3];
+            VectorClass w = ~(z0 | z1 | z2 | z3);
+            z0 |= w & (x[0] | y[0]);
+            z1 |= w & (x[1] | y[1]);
+            z2 |= w & (x[2] | y[2]);
+            z3 |= w & (x[3] | y[3]);
+            w = ~((z0 & t[0]) | (z1 & t[1]) | (z2 & t[2]) | (z3 & t[3]));
+            score += fast_popcount(w);
+            if (score >= lower_bound)
+                break;
+        }
+        break;
+    default:
+        for (int site = 0; site < nsites; site++) {
+            size_t offset = entry_size*site;
+            VectorClass *x = (VectorClass*)(node_pars + offset);
+            VectorClass *y = (VectorClass*)(dad_pars + offset);
+            VectorClass *t = (VectorClass*)(subtree_pars + offset);
+            int i;
+            VectorClass w = 0;
+            for (i = 0; i < nstates; i++)
+                w |= x[i] & y[i];
+            w = ~w;
+            VectorClass u = 0;
+            for (i = 0; i < nstates; i++)
+                u |= ((x[i] & y[i]) | (w & (x[i] | y[i]))) & t[i];
+            u = ~u;
+            score += fast_popcount(u);
+            if (score >= lower_bound)
+                break;
+        }
+        break;
+    }
+    return score;
+}
+
+template<class VectorClass>
+bool PhyloTree::computeParsimonyStatesFastSIMD(UINT *left_pars, UINT *right_pars, UINT *pars) {
+    int nstates = aln->getMaxNumStates();
+    const int NUM_BITS = VectorClass::size() * UINT_BITS;
+    int nsites = (aln->num_parsimony_sites + NUM_BITS - 1)/NUM_BITS;
+    int entry_size = nstates * VectorClass::size();
+    VectorClass changed = 0;
+
+    for (int site = 0; site < nsites; site++) {
+        size_t offset = entry_size*site;
+        VectorClass *x = (VectorClass*)(left_pars + offset);
+        VectorClass *y = (VectorClass*)(right_pars + offset);
+        VectorClass *z = (VectorClass*)(pars + offset);
+        int i;
+        VectorClass w = 0;
+        for (i = 0; i < nstates; i++)
+            w |= x[i] & y[i];
+        w = ~w;
+        for (i = 0; i < nstates; i++) {
+            VectorClass states = (x[i] & y[i]) | (w & (x[i] | y[i]));
+            changed |= states ^ z[i];
+            z[i] = states;
+        }
+    }
+    return fast_popcount(changed) != 0;
+}
+
 /****************************************************************************
  Sankoff parsimony function
  ****************************************************************************/
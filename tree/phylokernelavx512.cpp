@@ -27,11 +27,30 @@
 #error "You must compile this file with AVX512 enabled!"
 #endif
 
+void PhyloTree::setParsimonyKernelAVX512() {
+    if (cost_matrix) {
+        // Sankoff kernel
+        setParsimonyKernelAVX();
+        return;
+    }
+    // Fitch kernel, 512 sites per bit vector
+    computeParsimonyBranchPointer = &PhyloTree::computeParsimonyBranchFastSIMD<Vec16ui>;
+    computePartialParsimonyPointer = &PhyloTree::computePartialParsimonyFastSIMD<Vec16ui>;
+    computeParsimonyInsertCostPointer = &PhyloTree::computeParsimonyInsertCostFastSIMD<Vec16ui>;
+    computeParsimonyStatesPointer = &PhyloTree::computeParsimonyStatesFastSIMD<Vec16ui>;
+}
+
 void PhyloTree::setDotProductAVX512() {
 #ifdef BOOT_VAL_FLOAT
 		dotProduct = &PhyloTree::dotProductSIMD<float, Vec16f>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<float, Vec16f, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<float, Vec16f, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<float, Vec16f, uint16_t>;
 #else
 		dotProduct = &PhyloTree::dotProductSIMD<double, Vec8d>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<double, Vec8d, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<double, Vec8d, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<double, Vec8d, uint16_t>;
 #endif
         dotProductDouble = &PhyloTree::dotProductSIMD<double, Vec8d>;
 }
@@ -90,17 +109,31 @@ void PhyloTree::setLikelihoodKernelAVX512() {
 
     if ((model_factory && !model_factory->model->isReversible()) || params->kernel_nonrev) {
         // if nonreversible model
+        if (safe_numeric)
         switch (aln->num_states) {
         case 4:
-            computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchSIMD <Vec8d, 4, true>;
-            computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervSIMD   <Vec8d, 4, true>;
-            computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodSIMD<Vec8d, 4, true>;
+            computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchSIMD <Vec8d, SAFE_LH, 4, true>;
+            computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervSIMD   <Vec8d, SAFE_LH, 4, true>;
+            computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodSIMD<Vec8d, SAFE_LH, 4, true>;
             break;
         default:
-            computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchGenericSIMD <Vec8d>;
-            computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervGenericSIMD   <Vec8d>;
-            computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodGenericSIMD<Vec8d>;
+            computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchGenericSIMD <Vec8d, SAFE_LH, true>;
+            computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervGenericSIMD   <Vec8d, SAFE_LH, true>;
+            computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodGenericSIMD<Vec8d, SAFE_LH, true>;
             break;
+        } else {
+            switch (aln->num_states) {
+                case 4:
+                    computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchSIMD <Vec8d, NORM_LH, 4, true>;
+                    computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervSIMD   <Vec8d, NORM_LH, 4, true>;
+                    computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodSIMD<Vec8d, NORM_LH, 4, true>;
+                    break;
+                default:
+                    computeLikelihoodBranchPointer  = &PhyloTree::computeNonrevLikelihoodBranchGenericSIMD <Vec8d, NORM_LH, true>;
+                    computeLikelihoodDervPointer    = &PhyloTree::computeNonrevLikelihoodDervGenericSIMD   <Vec8d, NORM_LH, true>;
+                    computePartialLikelihoodPointer = &PhyloTree::computeNonrevPartialLikelihoodGenericSIMD<Vec8d, NORM_LH, true>;
+                    break;
+            }
         }
         computeLikelihoodFromBufferPointer = NULL;
         return;        
@@ -27,8 +27,14 @@
 void PhyloTree::setDotProductFMA() {
 #ifdef BOOT_VAL_FLOAT
 		dotProduct = &PhyloTree::dotProductSIMD<float, Vec8f>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<float, Vec8f, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<float, Vec8f, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<float, Vec8f, uint16_t>;
 #else
 		dotProduct = &PhyloTree::dotProductSIMD<double, Vec4d>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<double, Vec4d, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<double, Vec4d, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<double, Vec4d, uint16_t>;
 #endif
         dotProductDouble = &PhyloTree::dotProductSIMD<double, Vec4d>;
 }
@@ -18,6 +18,7 @@
 #endif
 
 #include "phylotree.h"
+#include <cfloat>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -883,6 +884,125 @@ inline void scaleLikelihood(VectorClass &lh_max, double *invar, double *dad_part
     }
 }
 
+#ifndef KERNEL_FIX_STATES
+/**
+    load the partial likelihoods of VectorClass::size() patterns from a
+    single-precision partial_lh vector (see PhyloTree::lk_float)
+    @param partial_lh single-precision partial_lh vector
+    @param bias_offset number of floats before the bias flags, PhyloTree::getPartialLhEntries()
+    @param ptn first pattern
+    @param block number of entries per pattern
+    @param[out] buffer block*VectorClass::size() doubles, aligned
+    @return buffer
+*/
+template <class VectorClass>
+inline VectorClass *loadFloatPartialLh(double *partial_lh, size_t bias_offset, size_t ptn, size_t block, double *buffer)
+{
+    const size_t V = VectorClass::size();
+    float *src = (float*)partial_lh + ptn*block;
+    unsigned char *bias = (unsigned char*)((float*)partial_lh + bias_offset) + ptn;
+    double scale[V];
+    for (size_t x = 0; x < V; x++)
+        scale[x] = bias[x] ? ldexp(1.0, -FLOAT_LH_BIAS_EXP) : 1.0;
+    for (size_t i = 0; i < block; i++, src += V)
+        for (size_t x = 0; x < V; x++)
+            buffer[i*V+x] = src[x] * scale[x];
+    return (VectorClass*)buffer;
+}
+
+/**
+    store the partial likelihoods of VectorClass::size() patterns into a
+    single-precision partial_lh vector; patterns whose largest entry lies below
+    FLOAT_LH_BIAS_THRESHOLD are stored multiplied by 2^FLOAT_LH_BIAS_EXP
+    @param buffer block*VectorClass::size() doubles
+    @param partial_lh single-precision partial_lh vector
+    @param bias_offset number of floats before the bias flags, PhyloTree::getPartialLhEntries()
+    @param ptn first pattern
+    @param block number of entries per pattern
+    @return FALSE if some pattern is not representable in single precision
+*/
+template <class VectorClass>
+inline bool storeFloatPartialLh(double *buffer, double *partial_lh, size_t bias_offset, size_t ptn, size_t block)
+{
+    bool representable = true;
+    const size_t V = VectorClass::size();
+    float *dst = (float*)partial_lh + ptn*block;
+    unsigned char *bias = (unsigned char*)((float*)partial_lh + bias_offset) + ptn;
+    double lh_max[V], scale[V];
+    for (size_t x = 0; x < V; x++)
+        lh_max[x] = 0.0;
+    for (size_t i = 0; i < block; i++)
+        for (size_t x = 0; x < V; x++)
+            lh_max[x] = max(lh_max[x], fabs(buffer[i*V+x]));
+    for (size_t x = 0; x < V; x++) {
+        bias[x] = (lh_max[x] < FLOAT_LH_BIAS_THRESHOLD);
+        scale[x] = bias[x] ? ldexp(1.0, FLOAT_LH_BIAS_EXP) : 1.0;
+        double stored_max = lh_max[x] * scale[x];
+        if ((stored_max < FLT_MIN && stored_max != 0.0) || !(stored_max <= FLT_MAX))
+            representable = false;
+    }
+    for (size_t i = 0; i < block; i++, dst += V)
+        for (size_t x = 0; x < V; x++)
+            dst[x] = buffer[i*V+x] * scale[x];
+    return representable;
+}
+
+/**
+    check if all VectorClass::size() patterns starting at ptn repeat a pattern
+    of an earlier packet in [ptn_lower, ptn), computed by the same thread before
+    @param ptn_rep site repeats of dad_branch (see PhyloTree::getSiteRepeats)
+    @param ptn_invar invariant site likelihoods, constant sites are not scaled
+    @param ptn first pattern
+    @param ptn_lower first pattern of the current packet
+*/
+template <class VectorClass>
+inline bool isSiteRepeatPacket(const int *ptn_rep, const double *ptn_invar, size_t ptn, size_t ptn_lower)
+{
+    for (size_t x = 0; x < VectorClass::size(); x++) {
+        size_t rep = ptn_rep[ptn+x];
+        if (rep >= ptn || rep < ptn_lower || (ptn_invar[rep] == 0.0) != (ptn_invar[ptn+x] == 0.0))
+            return false;
+    }
+    return true;
+}
+
+/**
+    copy partial likelihoods and scaling numbers of VectorClass::size() patterns
+    from their site repeats, see isSiteRepeatPacket()
+    @param partial_lh partial_lh vector of dad_branch
+    @param scale_num scale_num vector of dad_branch
+    @param ptn_rep site repeats of dad_branch
+    @param ptn first pattern
+    @param block number of entries per pattern
+    @param ncat_mix number of scaling numbers per pattern if SAFE_NUMERIC
+    @param float_offset PhyloTree::getPartialLhEntries() for single precision, 0 otherwise
+*/
+template <class VectorClass, const bool SAFE_NUMERIC>
+inline void copySiteRepeatPacket(double *partial_lh, UBYTE *scale_num, const int *ptn_rep,
+                                 size_t ptn, size_t block, size_t ncat_mix, size_t float_offset)
+{
+    const size_t V = VectorClass::size();
+    for (size_t x = 0; x < V; x++) {
+        size_t rep = ptn_rep[ptn+x];
+        size_t src = (rep - rep % V)*block + rep % V, dst = ptn*block + x;
+        if (float_offset) {
+            float *lh = (float*)partial_lh;
+            for (size_t i = 0; i < block; i++)
+                lh[dst+i*V] = lh[src+i*V];
+            unsigned char *bias = (unsigned char*)(lh + float_offset);
+            bias[ptn+x] = bias[rep];
+        } else {
+            for (size_t i = 0; i < block; i++)
+                partial_lh[dst+i*V] = partial_lh[src+i*V];
+        }
+        if (SAFE_NUMERIC)
+            memcpy(scale_num + (ptn+x)*ncat_mix, scale_num + rep*ncat_mix, ncat_mix);
+        else
+            scale_num[ptn+x] = scale_num[rep];
+    }
+}
+#endif
+
 
 /*******************************************************
  *
@@ -1261,12 +1381,17 @@ void PhyloTree::computeTraversalInfo(PhyloNode *node, PhyloNode *dad, bool compu
         }
     }
 
-    if (compute_partial_lh) {
+    // task graph: compute now, the callers then find traversal_info empty
+    bool task_graph = isTraversalTaskGraph();
+    if (compute_partial_lh || task_graph) {
         vector<size_t> limits;
         size_t orig_nptn = roundUpToMultiple(aln->size(), VectorClass::size());
         size_t nptn      = roundUpToMultiple(orig_nptn+model_factory->unobserved_ptns.size(),VectorClass::size());
         computeBounds<VectorClass>(num_threads, num_packets, nptn, limits);
 
+        if (task_graph) {
+            computePartialLikelihoodTasks(limits);
+        } else {
         #ifdef _OPENMP
         #pragma omp parallel for schedule(dynamic,1) num_threads(num_threads)
         #endif
@@ -1275,6 +1400,7 @@ void PhyloTree::computeTraversalInfo(PhyloNode *node, PhyloNode *dad, bool compu
                 computePartialLikelihood(*it, limits[packet_id], limits[packet_id+1], packet_id);
             }
         }
+        }
         traversal_info.clear();
     }
     return;
@@ -1332,6 +1458,18 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
     size_t tip_mem_size = max_orig_nptn * nstates;
     size_t scale_size = SAFE_NUMERIC ? (ptn_upper-ptn_lower) * ncat_mix : (ptn_upper-ptn_lower);
 
+    // single precision: children are loaded into and dad is computed in the double buffers of this packet
+    size_t float_offset = lk_float ? getPartialLhEntries() : 0;
+    double *float_buffer = NULL, *float_child = NULL, *float_right = NULL;
+    if (lk_float) {
+        float_buffer = buffer_float_lh + 3*block*VectorClass::size()*packet_id;
+        float_child = float_buffer + block*VectorClass::size();
+        float_right = float_child + block*VectorClass::size();
+    }
+
+    // patterns repeating an earlier pattern in the subtree are copied instead of computed
+    const int *ptn_rep = SITE_MODEL ? NULL : getSiteRepeats(dad_branch);
+
 	double *evec = model->getEigenvectors();
 	double *inv_evec = model->getInverseEigenvectors();
 	ASSERT(inv_evec && evec);
@@ -1412,6 +1550,11 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
         double *vec_tip = (double*)&partial_lh_all[block];
 
         for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
+            if (ptn_rep && isSiteRepeatPacket<VectorClass>(ptn_rep, ptn_invar, ptn, ptn_lower)) {
+                copySiteRepeatPacket<VectorClass, SAFE_NUMERIC>(dad_branch->partial_lh, dad_branch->scale_num, ptn_rep,
+                    ptn, block, ncat_mix, float_offset);
+                continue;
+            }
             for (size_t i = 0; i < block; i++){
                 partial_lh_all[i] = 1.0;
             }
@@ -1459,7 +1602,8 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                     } else {
                         // internal node
                         VectorClass *partial_lh = partial_lh_all;
-                        VectorClass *partial_lh_child = (VectorClass*)(child->partial_lh + ptn*block);
+                        VectorClass *partial_lh_child = lk_float ? loadFloatPartialLh<VectorClass>(child->partial_lh, float_offset, ptn, block, float_child)
+                            : (VectorClass*)(child->partial_lh + ptn*block);
                         if (!SAFE_NUMERIC) {
                             for (size_t i = 0; i < VectorClass::size(); i++)
                                 dad_branch->scale_num[ptn+i] += child->scale_num[ptn+i];
@@ -1526,7 +1670,8 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                     } else {
                         // internal node
                         VectorClass *partial_lh = partial_lh_all;
-                        VectorClass *partial_lh_child = (VectorClass*)(child->partial_lh + ptn*block);
+                        VectorClass *partial_lh_child = lk_float ? loadFloatPartialLh<VectorClass>(child->partial_lh, float_offset, ptn, block, float_child)
+                            : (VectorClass*)(child->partial_lh + ptn*block);
                         if (!SAFE_NUMERIC) {
                             for (size_t i = 0; i < VectorClass::size(); i++)
                                 dad_branch->scale_num[ptn+i] += child->scale_num[ptn+i];
@@ -1603,7 +1748,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
         
             // compute dot-product with inv_eigenvector
             VectorClass *partial_lh_tmp = partial_lh_all;
-            VectorClass *partial_lh = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+            VectorClass *partial_lh = (VectorClass*)(lk_float ? float_buffer : dad_branch->partial_lh + ptn*block);
             VectorClass lh_max = 0.0;
             double *inv_evec_ptr = SITE_MODEL ? &inv_evec[ptn*states_square] : NULL;
             for (size_t c = 0; c < ncat_mix; c++) {
@@ -1625,6 +1770,12 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                 partial_lh += nstates;
                 partial_lh_tmp += nstates;
             }
+            if (lk_float && !storeFloatPartialLh<VectorClass>(float_buffer, dad_branch->partial_lh, float_offset, ptn, block)) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                lk_float_underflow = true;
+            }
 
         } // for ptn
 
@@ -1648,7 +1799,12 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
         auto unknown = aln->STATE_UNKNOWN;
 
         for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
-            VectorClass *partial_lh = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+            if (ptn_rep && isSiteRepeatPacket<VectorClass>(ptn_rep, ptn_invar, ptn, ptn_lower)) {
+                copySiteRepeatPacket<VectorClass, SAFE_NUMERIC>(dad_branch->partial_lh, dad_branch->scale_num, ptn_rep,
+                    ptn, block, ncat_mix, float_offset);
+                continue;
+            }
+            VectorClass *partial_lh = (VectorClass*)(lk_float ? float_buffer : dad_branch->partial_lh + ptn*block);
 
             if (SITE_MODEL) {
                 VectorClass* expleft = (VectorClass*) vec_left;
@@ -1742,6 +1898,12 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                     partial_lh += nstates;
                 } // FOR category
             } // IF SITE_MODEL
+            if (lk_float && !storeFloatPartialLh<VectorClass>(float_buffer, dad_branch->partial_lh, float_offset, ptn, block)) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                lk_float_underflow = true;
+            }
 		} // FOR LOOP
 
 
@@ -1765,8 +1927,15 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
         auto unknown = aln->STATE_UNKNOWN;
         
         for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
-            VectorClass *partial_lh = (VectorClass*)(dad_branch->partial_lh + ptn*block);
-            VectorClass *partial_lh_right = (VectorClass*)(right->partial_lh + ptn*block);
+            if (ptn_rep && isSiteRepeatPacket<VectorClass>(ptn_rep, ptn_invar, ptn, ptn_lower)) {
+                copySiteRepeatPacket<VectorClass, SAFE_NUMERIC>(dad_branch->partial_lh, dad_branch->scale_num, ptn_rep,
+                    ptn, block, ncat_mix, float_offset);
+                continue;
+            }
+            double *dad_ptn_lh = lk_float ? float_buffer : dad_branch->partial_lh + ptn*block;
+            VectorClass *partial_lh = (VectorClass*)dad_ptn_lh;
+            VectorClass *partial_lh_right = lk_float ? loadFloatPartialLh<VectorClass>(right->partial_lh, float_offset, ptn, block, float_right)
+                : (VectorClass*)(right->partial_lh + ptn*block);
             VectorClass lh_max = 0.0;
 
             if (SITE_MODEL) {
@@ -1804,7 +1973,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                             if (underflown[x]) {
                                 // BQM 2016-05-03: only scale for non-constant sites
                                 // now do the likelihood scaling
-                                double *partial_lh = dad_branch->partial_lh + (ptn*block + c*nstates*VectorClass::size() + x);
+                                double *partial_lh = dad_ptn_lh + (c*nstates*VectorClass::size() + x);
                                 for (size_t i = 0; i < nstates; i++)
                                     partial_lh[i*VectorClass::size()] = ldexp(partial_lh[i*VectorClass::size()], SCALING_THRESHOLD_EXP);
                                 dad_branch->scale_num[(ptn+x)*ncat_mix+c] += 1;
@@ -1872,7 +2041,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                                 if (underflown[x]) {
                                     // BQM 2016-05-03: only scale for non-constant sites
                                     // now do the likelihood scaling
-                                    double *partial_lh = dad_branch->partial_lh + (ptn*block + c*nstates*VectorClass::size() + x);
+                                    double *partial_lh = dad_ptn_lh + (c*nstates*VectorClass::size() + x);
                                     for (size_t i = 0; i < nstates; i++)
                                         partial_lh[i*VectorClass::size()] = ldexp(partial_lh[i*VectorClass::size()], SCALING_THRESHOLD_EXP);
                                     dad_branch->scale_num[(ptn+x)*ncat_mix+c] += 1;
@@ -1891,7 +2060,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                 if (horizontal_or(underflown)) { // at least one site has numerical underflown
                     for (size_t x = 0; x < VectorClass::size(); x++)
                     if (underflown[x]) {
-                        double *partial_lh = dad_branch->partial_lh + (ptn*block + x);
+                        double *partial_lh = dad_ptn_lh + x;
                         // now do the likelihood scaling
                         for (size_t i = 0; i < block; i++) {
                             partial_lh[i*VectorClass::size()] = ldexp(partial_lh[i*VectorClass::size()], SCALING_THRESHOLD_EXP);
@@ -1901,6 +2070,12 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                     }
                 }
             }
+            if (lk_float && !storeFloatPartialLh<VectorClass>(float_buffer, dad_branch->partial_lh, float_offset, ptn, block)) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                lk_float_underflow = true;
+            }
 
 		} // big for loop over ptn
 
@@ -1911,9 +2086,17 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
         VectorClass *partial_lh_tmp
             = (VectorClass*)(buffer_partial_lh_ptr + thread_buf_size * packet_id);
 		for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
-			VectorClass *partial_lh = (VectorClass*)(dad_branch->partial_lh + ptn*block);
-			VectorClass *partial_lh_left = (VectorClass*)(left->partial_lh + ptn*block);
-			VectorClass *partial_lh_right = (VectorClass*)(right->partial_lh + ptn*block);
+			if (ptn_rep && isSiteRepeatPacket<VectorClass>(ptn_rep, ptn_invar, ptn, ptn_lower)) {
+				copySiteRepeatPacket<VectorClass, SAFE_NUMERIC>(dad_branch->partial_lh, dad_branch->scale_num, ptn_rep,
+					ptn, block, ncat_mix, float_offset);
+				continue;
+			}
+			double *dad_ptn_lh = lk_float ? float_buffer : dad_branch->partial_lh + ptn*block;
+			VectorClass *partial_lh = (VectorClass*)dad_ptn_lh;
+			VectorClass *partial_lh_left = lk_float ? loadFloatPartialLh<VectorClass>(left->partial_lh, float_offset, ptn, block, float_child)
+				: (VectorClass*)(left->partial_lh + ptn*block);
+			VectorClass *partial_lh_right = lk_float ? loadFloatPartialLh<VectorClass>(right->partial_lh, float_offset, ptn, block, float_right)
+				: (VectorClass*)(right->partial_lh + ptn*block);
             VectorClass lh_max = 0.0;
             UBYTE *scale_dad, *scale_left, *scale_right;
 
@@ -1998,7 +2181,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                         if (underflown[x]) {
                             // BQM 2016-05-03: only scale for non-constant sites
                             // now do the likelihood scaling
-                            double *partial_lh = dad_branch->partial_lh + (ptn*block + c*nstates*VectorClass::size() + x);
+                            double *partial_lh = dad_ptn_lh + (c*nstates*VectorClass::size() + x);
                             for (size_t i = 0; i < nstates; i++)
                                 partial_lh[i*VectorClass::size()] = ldexp(partial_lh[i*VectorClass::size()], SCALING_THRESHOLD_EXP);
                             scale_dad[x*ncat_mix] += 1;
@@ -2018,7 +2201,7 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                 if (horizontal_or(underflown)) { // at least one site has numerical underflown
                     for (size_t x = 0; x < VectorClass::size(); x++)
                     if (underflown[x]) {
-                        double *partial_lh = dad_branch->partial_lh + (ptn*block + x);
+                        double *partial_lh = dad_ptn_lh + x;
                         // now do the likelihood scaling
                         for (size_t i = 0; i < block; i++) {
                             partial_lh[i*VectorClass::size()] = ldexp(partial_lh[i*VectorClass::size()], SCALING_THRESHOLD_EXP);
@@ -2028,6 +2211,12 @@ void PhyloTree::computePartialLikelihoodGenericSIMD(TraversalInfo &info
                     }
                 }
             }
+            if (lk_float && !storeFloatPartialLh<VectorClass>(float_buffer, dad_branch->partial_lh, float_offset, ptn, block)) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                lk_float_underflow = true;
+            }
         } // big for loop over ptn
     }
 
@@ -2088,6 +2277,10 @@ void PhyloTree::computeLikelihoodBufferGenericSIMD(PhyloNeighbor *dad_branch, Ph
         computePartialLikelihood(*it, ptn_lower, ptn_upper, packet_id);
     }
 
+    // single precision: partial_lh of node and dad are loaded into double buffers
+    size_t float_offset = lk_float ? getPartialLhEntries() : 0;
+    double *float_buffer = lk_float ? buffer_float_lh + 3*block*VectorClass::size()*packet_id : NULL;
+
     if (dad->isLeaf()) {
         // special treatment for TIP-INTERNAL NODE case
         double *tip_partial_lh_node = &tip_partial_lh[dad->id * max_orig_nptn * nstates];
@@ -2098,7 +2291,8 @@ void PhyloTree::computeLikelihoodBufferGenericSIMD(PhyloNeighbor *dad_branch, Ph
         size_t offset     = ptn_lower*block;
         size_t offsetStep = block*VectorClass::size();
         for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size(), offset+=offsetStep) {
-            VectorClass *partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + offset);
+            VectorClass *partial_lh_dad = lk_float ? loadFloatPartialLh<VectorClass>(dad_branch->partial_lh, float_offset, ptn, block, float_buffer)
+                : (VectorClass*)(dad_branch->partial_lh + offset);
             VectorClass *theta = (VectorClass*)(theta_all + offset);
             //load tip vector
             if (!SITE_MODEL) {
@@ -2182,8 +2376,14 @@ void PhyloTree::computeLikelihoodBufferGenericSIMD(PhyloNeighbor *dad_branch, Ph
         // now compute theta
         for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
             VectorClass *theta = (VectorClass*)(theta_all + ptn*block);
-            VectorClass *partial_lh_node = (VectorClass*)(node_branch->partial_lh + ptn*block);
-            VectorClass *partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+            VectorClass *partial_lh_node, *partial_lh_dad;
+            if (lk_float) {
+                partial_lh_node = loadFloatPartialLh<VectorClass>(node_branch->partial_lh, float_offset, ptn, block, float_buffer);
+                partial_lh_dad = loadFloatPartialLh<VectorClass>(dad_branch->partial_lh, float_offset, ptn, block, float_buffer + block*VectorClass::size());
+            } else {
+                partial_lh_node = (VectorClass*)(node_branch->partial_lh + ptn*block);
+                partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+            }
             for (size_t i = 0; i < block; i++) {
                 theta[i] = partial_lh_node[i] * partial_lh_dad[i];
             }
@@ -2689,6 +2889,7 @@ double PhyloTree::computeLikelihoodBranchGenericSIMD(PhyloNeighbor *dad_branch,
 
     double *val = nullptr;
     double *buffer_partial_lh_ptr = buffer_partial_lh;
+    size_t float_offset = lk_float ? getPartialLhEntries() : 0;
 
     double cat_length[ncat];
     double cat_prop[ncat];
@@ -2805,11 +3006,13 @@ double PhyloTree::computeLikelihoodBranchGenericSIMD(PhyloNeighbor *dad_branch,
                 computePartialLikelihood(*it, ptn_lower, ptn_upper, packet_id);
             }
             double *vec_tip = buffer_partial_lh_ptr + block*VectorClass::size() * packet_id;
+            double *float_buffer = lk_float ? buffer_float_lh + 3*block*VectorClass::size()*packet_id : NULL;
 
             for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
                 VectorClass lh_ptn(0.0);
                 VectorClass *lh_cat = (VectorClass*)(_pattern_lh_cat + ptn*ncat_mix);
-                VectorClass *partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+                VectorClass *partial_lh_dad = lk_float ? loadFloatPartialLh<VectorClass>(dad_branch->partial_lh, float_offset, ptn, block, float_buffer)
+                    : (VectorClass*)(dad_branch->partial_lh + ptn*block);
                 VectorClass *lh_node = SITE_MODEL ? (VectorClass*)&partial_lh_node[ptn*nstates] : (VectorClass*)vec_tip;
 
                 if (SITE_MODEL) {
@@ -2959,11 +3162,18 @@ double PhyloTree::computeLikelihoodBranchGenericSIMD(PhyloNeighbor *dad_branch,
 
             VectorClass vc_tree_lh(0.0);
             VectorClass vc_prob_const(0.0);
+            double *float_buffer = lk_float ? buffer_float_lh + 3*block*VectorClass::size()*packet_id : NULL;
             for (size_t ptn = ptn_lower; ptn < ptn_upper; ptn+=VectorClass::size()) {
                 VectorClass lh_ptn(0.0);
                 VectorClass *lh_cat = (VectorClass*)(_pattern_lh_cat + ptn*ncat_mix);
-                VectorClass *partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + ptn*block);
-                VectorClass *partial_lh_node = (VectorClass*)(node_branch->partial_lh + ptn*block);
+                VectorClass *partial_lh_dad, *partial_lh_node;
+                if (lk_float) {
+                    partial_lh_dad = loadFloatPartialLh<VectorClass>(dad_branch->partial_lh, float_offset, ptn, block, float_buffer);
+                    partial_lh_node = loadFloatPartialLh<VectorClass>(node_branch->partial_lh, float_offset, ptn, block, float_buffer + block*VectorClass::size());
+                } else {
+                    partial_lh_dad = (VectorClass*)(dad_branch->partial_lh + ptn*block);
+                    partial_lh_node = (VectorClass*)(node_branch->partial_lh + ptn*block);
+                }
 
                 // compute likelihood per category
                 if (SITE_MODEL) {
@@ -34,13 +34,21 @@ void PhyloTree::setParsimonyKernelSSE() {
     // Fitch kernel
 	computeParsimonyBranchPointer = &PhyloTree::computeParsimonyBranchFastSIMD<Vec4ui>;
     computePartialParsimonyPointer = &PhyloTree::computePartialParsimonyFastSIMD<Vec4ui>;
+    computeParsimonyInsertCostPointer = &PhyloTree::computeParsimonyInsertCostFastSIMD<Vec4ui>;
+    computeParsimonyStatesPointer = &PhyloTree::computeParsimonyStatesFastSIMD<Vec4ui>;
 }
 
 void PhyloTree::setDotProductSSE() {
 #ifdef BOOT_VAL_FLOAT
 		dotProduct = &PhyloTree::dotProductSIMD<float, Vec4f>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<float, Vec4f, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<float, Vec4f, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<float, Vec4f, uint16_t>;
 #else
 		dotProduct = &PhyloTree::dotProductSIMD<double, Vec2d>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<double, Vec2d, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<double, Vec2d, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<double, Vec2d, uint16_t>;
 #endif
         dotProductDouble = &PhyloTree::dotProductSIMD<double, Vec2d>;
 }
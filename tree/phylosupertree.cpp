@@ -629,6 +629,31 @@ void PhyloSuperTree::clearAllPartialLH(bool make_null) {
     }
 }
 
+bool PhyloSuperTree::setLikelihoodFloat(bool enable) {
+    bool result = false;
+    for (iterator it = begin(); it != end(); it++)
+        if ((*it)->setLikelihoodFloat(enable))
+            result = true;
+    return result;
+}
+
+bool PhyloSuperTree::isLikelihoodFloatUnderflown() {
+    for (iterator it = begin(); it != end(); it++)
+        if ((*it)->isLikelihoodFloatUnderflown())
+            return true;
+    return false;
+}
+
+void PhyloSuperTree::getPartialLhCounters(size_t &computed, size_t &reused) {
+    computed = reused = 0;
+    for (iterator it = begin(); it != end(); it++) {
+        size_t part_computed, part_reused;
+        (*it)->getPartialLhCounters(part_computed, part_reused);
+        computed += part_computed;
+        reused += part_reused;
+    }
+}
+
 int PhyloSuperTree::computeParsimonyBranchObsolete(PhyloNeighbor *dad_branch, PhyloNode *dad, int *branch_subst) {
     int score = 0, part = 0;
     SuperNeighbor *dad_nei = (SuperNeighbor*)dad_branch;
@@ -1343,7 +1368,7 @@ void PhyloSuperTree::initMarginalAncestralState(ostream &out, bool &orig_kernel_
     for (auto it = begin(); it != end(); it++) {
         size_t nptn = (*it)->aln->size();
         size_t nstates = (*it)->model->num_states;
-        (*it)->_pattern_lh_cat_state = (*it)->newPartialLh();
+        (*it)->_pattern_lh_cat_state = aligned_alloc<double>((*it)->getPartialLhEntries());
         total_size += nptn*nstates;
         total_ptn += nptn;
         if (nstates != front()->model->num_states)
@@ -260,6 +260,30 @@ public:
      NEWLY ADDED (2014-12-04): clear all partial likelihood for a clean computation again
      */
     virtual void clearAllPartialLH(bool make_null = false);
+
+    /**
+            switch partial likelihood vectors of all partition trees between single and double precision
+            @param enable TRUE for single precision
+            @return TRUE if some partition tree uses single precision afterwards
+     */
+    virtual bool setLikelihoodFloat(bool enable);
+
+    /** @return TRUE if a single-precision partial likelihood vector of some partition tree underflowed */
+    virtual bool isLikelihoodFloatUnderflown();
+
+    /**
+            partition trees have their own branch lengths, thus simply clear all partial likelihoods
+            @param lenvec saved branch lengths
+     */
+    virtual void clearChangedPartialLh(DoubleVector &lenvec) {
+        clearAllPartialLH();
+    }
+
+    /**
+        @param[out] computed number of partial likelihood vectors computed so far, summed over partitions
+        @param[out] reused number of partial likelihood vectors reused so far, summed over partitions
+     */
+    virtual void getPartialLhCounters(size_t &computed, size_t &reused);
     
 
     /**
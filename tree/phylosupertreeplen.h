@@ -121,6 +121,14 @@ public:
      */
     virtual void deleteAllPartialLh();
 
+    /**
+            single precision is not supported, partition trees share one partial likelihood memory block
+            @return FALSE
+     */
+    virtual bool setLikelihoodFloat(bool enable) {
+        return false;
+    }
+
 	/**
 	 * @return the type of NNI around node1-node2 for partition part
 	 */
@@ -100,6 +100,7 @@ void PhyloTree::init() {
     theta_all = NULL;
     buffer_scale_all = NULL;
     buffer_partial_lh = NULL;
+    buffer_float_lh = NULL;
     ptn_freq = NULL;
     ptn_freq_pars = NULL;
     ptn_invar = NULL;
@@ -132,8 +133,13 @@ void PhyloTree::init() {
     current_scaling = 1.0;
     is_opt_scaling = false;
     num_partial_lh_computations = 0;
+    num_partial_lh_reused = 0;
     vector_size = 0;
     safe_numeric = false;
+    lk_float = false;
+    lk_float_underflow = false;
+    site_repeats = false;
+    site_repeats_salt = 0;
     summary = nullptr;
     isSummaryBorrowed = false;
     progress = nullptr;
@@ -248,6 +254,7 @@ PhyloTree::~PhyloTree() {
     aligned_free(theta_all);
     aligned_free(buffer_scale_all);
     aligned_free(buffer_partial_lh);
+    aligned_free(buffer_float_lh);
     aligned_free(ptn_freq);
     aligned_free(ptn_freq_pars);
     ptn_freq_computed = false;
@@ -356,13 +363,28 @@ void PhyloTree::copyPhyloTree(PhyloTree *tree, bool borrowSummary) {
     if (!tree->aln)
         return;
     setAlignment(tree->aln);
-    if (borrowSummary && summary!=tree->summary && tree->summary!=nullptr) {
-        if (!isSummaryBorrowed) {
-            delete summary;
+    if (borrowSummary) {
+        this->borrowSummary(tree);
+    }
+}
+
+void PhyloTree::borrowSummary(PhyloTree *tree) {
+    if (summary==tree->summary) {
+        return;
+    }
+    if (tree->summary==nullptr) {
+        // the other tree may have deleted the summary we borrowed
+        if (isSummaryBorrowed) {
+            summary           = nullptr;
+            isSummaryBorrowed = false;
         }
-        summary           = tree->summary;
-        isSummaryBorrowed = (summary!=nullptr);
+        return;
     }
+    if (!isSummaryBorrowed) {
+        delete summary;
+    }
+    summary           = tree->summary;
+    isSummaryBorrowed = true;
 }
 
 void PhyloTree::copyPhyloTreeMixlen(PhyloTree *tree, int mix, bool borrowSummary) {
@@ -378,6 +400,8 @@ void PhyloTree::copyPhyloTreeMixlen(PhyloTree *tree, int mix, bool borrowSummary
 #define FAST_NAME_CHECK 1
 void PhyloTree::setAlignment(Alignment *alignment) {
     aln = alignment;
+    // site repeats kept in partial_lh belong to the old alignment
+    site_repeats_salt = newSiteRepeatsSalt();
     //double checkStart = getRealTime();
     size_t nseq = aln->getNSeq();
     bool err = false;
@@ -743,6 +767,48 @@ void PhyloTree::restoreBranchLengths(DoubleVector &lenvec, int startid, PhyloNod
 }
 
 
+void PhyloTree::clearChangedPartialLh(DoubleVector &lenvec) {
+    IntVector num_below(nodeNum, 0);
+    int total = countChangedBranches(lenvec, num_below, (PhyloNode*)root, NULL);
+    if (total > 0)
+        clearChangedPartialLh(lenvec, num_below, total, (PhyloNode*)root, NULL);
+}
+
+int PhyloTree::countChangedBranches(DoubleVector &lenvec, IntVector &num_below, PhyloNode *node, PhyloNode *dad) {
+    int num = 0;
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        num += countChangedBranches(lenvec, num_below, (PhyloNode*)(*it)->node, node);
+    }
+    num_below[node->id] = num;
+    if (dad) {
+        Neighbor *nei = node->findNeighbor(dad);
+        for (int i = 0; i < getMixlen(); i++)
+            if (nei->getLength(i) != lenvec[nei->id*getMixlen() + i]) {
+                num++;
+                break;
+            }
+    }
+    return num;
+}
+
+void PhyloTree::clearChangedPartialLh(DoubleVector &lenvec, IntVector &num_below, int total, PhyloNode *node, PhyloNode *dad) {
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        PhyloNode *child = (PhyloNode*)(*it)->node;
+        int num_child = num_below[child->id];
+        bool changed = false;
+        for (int i = 0; i < getMixlen(); i++)
+            if ((*it)->getLength(i) != lenvec[(*it)->id*getMixlen() + i])
+                changed = true;
+        // partial_lh towards child covers the branches below child
+        if (num_child > 0)
+            ((PhyloNeighbor*)(*it))->clearPartialLh();
+        // partial_lh towards node covers all but the subtree of child and the branch in between
+        if (total - num_child - changed > 0)
+            ((PhyloNeighbor*)child->findNeighbor(node))->clearPartialLh();
+        clearChangedPartialLh(lenvec, num_below, total, child, node);
+    }
+}
+
 /****************************************************************************
  Parsimony function
  ****************************************************************************/
@@ -912,6 +978,11 @@ void PhyloTree::initializeAllPartialLh() {
     if (!buffer_partial_lh) {
         buffer_partial_lh = aligned_alloc<double>(getBufferPartialLhSize());
     }
+    if (lk_float && !buffer_float_lh) {
+        // 3 blocks of up to 8 patterns per packet: dad and two children
+        size_t block = model->num_states * site_rate->getNRate() * ((model_factory->fused_mix_rate)? 1 : model->getNMixtures());
+        buffer_float_lh = aligned_alloc<double>(3*block*8*num_packets);
+    }
     if (!ptn_freq) {
         ptn_freq = aligned_alloc<double>(mem_size);
         ptn_freq_computed = false;
@@ -920,6 +991,9 @@ void PhyloTree::initializeAllPartialLh() {
         ptn_freq_pars = aligned_alloc<UINT>(mem_size);
     if (!ptn_invar)
         ptn_invar = aligned_alloc<double>(mem_size);
+    // site repeats are stored behind the partial likelihoods, decide before allocation
+    if (!central_partial_lh)
+        site_repeats = params->site_repeats;
     initializeAllPartialLh(index, indexlh);
     if (params->lh_mem_save == LM_MEM_SAVE)
         mem_slots.init(this, max_lh_slots);
@@ -947,6 +1021,7 @@ void PhyloTree::deleteAllPartialLh() {
     aligned_free(theta_all);
     aligned_free(buffer_scale_all);
     aligned_free(buffer_partial_lh);
+    aligned_free(buffer_float_lh);
     aligned_free(_pattern_lh_cat);
     aligned_free(_pattern_lh);
     aligned_free(_site_lh);
@@ -989,6 +1064,10 @@ uint64_t PhyloTree::getMemoryRequired(size_t ncategory, bool full_mem) {
         mem_size += model->getMemoryRequired();
 
     int64_t lh_scale_size = block_size * sizeof(double) + scale_block_size * sizeof(UBYTE);
+    if (lk_float)
+        lh_scale_size = block_size * sizeof(float) + nptn + scale_block_size * sizeof(UBYTE);
+    if (site_repeats || params->site_repeats)
+        lh_scale_size += nptn * sizeof(int) + sizeof(uint64_t);
 
     max_lh_slots = leafNum-2;
 
@@ -1030,6 +1109,7 @@ void PhyloTree::getMemoryRequired(uint64_t &partial_lh_entries, uint64_t &scale_
     if (model_factory)
         block_size = get_safe_upper_limit(aln->getNPattern()) + max(get_safe_upper_limit(aln->num_states), get_safe_upper_limit(model_factory->unobserved_ptns.size()));
     size_t scale_size = block_size;
+    size_t nptn = block_size;
     block_size = block_size * aln->num_states;
     if (site_rate) {
         block_size *= site_rate->getNRate();
@@ -1043,6 +1123,14 @@ void PhyloTree::getMemoryRequired(uint64_t &partial_lh_entries, uint64_t &scale_
     uint64_t tip_partial_lh_size = aln->num_states * (aln->STATE_UNKNOWN+1) * model->getNMixtures();
     uint64_t tip_partial_pars_size = aln->num_states * (aln->STATE_UNKNOWN+1);
 
+    // single precision: two entries per double plus one bias flag per pattern
+    if (lk_float)
+        block_size = (block_size + 1) / 2 + (nptn + 7) / 8;
+
+    // site repeats: leaf-set key and one int per pattern
+    if (site_repeats)
+        block_size += (nptn + 1) / 2 + 1;
+
     // TODO mem save
     partial_lh_entries = ((uint64_t)leafNum - 2) * (uint64_t) block_size + 4 + tip_partial_lh_size;
     scale_num_entries = (leafNum - 2) * scale_size;
@@ -1057,7 +1145,7 @@ void PhyloTree::initializeAllPartialLh(int &index, int &indexlh, PhyloNode *node
     size_t nptn = get_safe_upper_limit(aln->size())+ max(get_safe_upper_limit(aln->num_states), get_safe_upper_limit(model_factory->unobserved_ptns.size()));
     uint64_t block_size;
     uint64_t scale_block_size = nptn * site_rate->getNRate() * ((model_factory->fused_mix_rate)? 1 : model->getNMixtures());
-    block_size = scale_block_size * model->num_states;
+    block_size = getPartialLhSize();
 
     if (!node) {
         node = (PhyloNode*) root;
@@ -1088,6 +1176,7 @@ void PhyloTree::initializeAllPartialLh(int &index, int &indexlh, PhyloNode *node
             }
             if (!central_partial_lh)
                 outError("Not enough memory for partial likelihood vectors");
+            site_repeats_salt = newSiteRepeatsSalt();
         }
 
         // now always assign tip_partial_lh
@@ -1186,6 +1275,122 @@ double *PhyloTree::newPartialLh() {
 }
 
 size_t PhyloTree::getPartialLhSize() {
+    size_t nptn = get_safe_upper_limit(aln->size())+max(get_safe_upper_limit(aln->num_states),
+        get_safe_upper_limit(model_factory->unobserved_ptns.size()));
+    size_t size = getPartialLhEntries();
+    // floats followed by one bias flag per pattern, rounded up to keep the next vector aligned
+    if (lk_float)
+        size = get_safe_upper_limit((size+1)/2 + (nptn+7)/8);
+    // leaf-set key and one int per pattern for the site repeats
+    if (site_repeats)
+        size += get_safe_upper_limit((nptn+1)/2 + 1);
+    return size;
+}
+
+uint64_t PhyloTree::newSiteRepeatsSalt() {
+    static uint64_t salt_counter = 0;
+    uint64_t salt;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+    salt = ++salt_counter;
+    return salt;
+}
+
+uint64_t *PhyloTree::getSiteRepeatsKey(PhyloNeighbor *nei) {
+    // with memory saving, later traversal nodes may reuse the slots of earlier ones
+    // before the kernels of those ran, see computeTraversalInfo()
+    if (!site_repeats || params->lh_mem_save == LM_MEM_SAVE || !nei->partial_lh)
+        return NULL;
+    size_t nptn = get_safe_upper_limit(aln->size())+max(get_safe_upper_limit(aln->num_states),
+        get_safe_upper_limit(model_factory->unobserved_ptns.size()));
+    return (uint64_t*)(nei->partial_lh + getPartialLhSize() - get_safe_upper_limit((nptn+1)/2 + 1));
+}
+
+int *PhyloTree::getSiteRepeats(PhyloNeighbor *nei) {
+    uint64_t *key = getSiteRepeatsKey(nei);
+    return key ? (int*)(key+1) : NULL;
+}
+
+void PhyloTree::computeSiteRepeats(PhyloNeighbor *dad_branch, PhyloNode *dad) {
+    PhyloNode *node = (PhyloNode*)dad_branch->node;
+    uint64_t *rep_key = getSiteRepeatsKey(dad_branch);
+    ASSERT(rep_key);
+    int *ptn_rep = (int*)(rep_key+1);
+    // same pattern range as the likelihood kernels
+    size_t orig_nptn = aln->size();
+    size_t max_orig_nptn = roundUpToMultiple(orig_nptn, vector_size);
+    size_t nptn = roundUpToMultiple(max_orig_nptn+model_factory->unobserved_ptns.size(), vector_size);
+
+    // the repeats only depend on the leaves below dad_branch: skip them if the
+    // subtree is unchanged since they were computed into this partial_lh
+    uint64_t key = 0;
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        PhyloNeighbor *child = (PhyloNeighbor*)*it;
+        if (child->node->isLeaf())
+            key += (((uint64_t)child->node->id + 1) * 0x9E3779B97F4A7C15ULL) ^ (site_repeats_salt * 0xC2B2AE3D27D4EB4FULL + nptn);
+        else
+            key += *getSiteRepeatsKey(child);
+    }
+    if (*rep_key == key)
+        return;
+
+    // open-addressing hash table: (representative so far, representative of child) -> first pattern
+    size_t hash_bits = 1;
+    while (((size_t)1 << hash_bits) < 2*nptn)
+        hash_bits++;
+    size_t hash_mask = ((size_t)1 << hash_bits) - 1;
+
+    bool first_child = true;
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        PhyloNeighbor *child = (PhyloNeighbor*)*it;
+        int *child_rep;
+        if (child->node->isLeaf()) {
+            // a tip pattern is represented by the first pattern with the same state
+            int leaf = child->node->id;
+            site_repeats_tip.resize(nptn);
+            site_repeats_state.assign(aln->STATE_UNKNOWN+1, -1);
+            for (size_t ptn = 0; ptn < nptn; ptn++) {
+                int state;
+                if (ptn < orig_nptn)
+                    state = aln->at(ptn)[leaf];
+                else if (ptn >= max_orig_nptn && ptn < max_orig_nptn+model_factory->unobserved_ptns.size())
+                    state = model_factory->unobserved_ptns[ptn-max_orig_nptn][leaf];
+                else
+                    state = aln->STATE_UNKNOWN;
+                if (site_repeats_state[state] < 0)
+                    site_repeats_state[state] = ptn;
+                site_repeats_tip[ptn] = site_repeats_state[state];
+            }
+            child_rep = site_repeats_tip.data();
+        } else {
+            child_rep = getSiteRepeats(child);
+            ASSERT(child_rep);
+        }
+        if (first_child) {
+            memcpy(ptn_rep, child_rep, nptn*sizeof(int));
+            first_child = false;
+            continue;
+        }
+        // two patterns repeat if they repeat in all subtrees merged so far
+        site_repeats_hash_key.assign(hash_mask+1, UINT64_MAX);
+        site_repeats_hash_ptn.resize(hash_mask+1);
+        for (size_t ptn = 0; ptn < nptn; ptn++) {
+            uint64_t pair = ((uint64_t)ptn_rep[ptn] << 32) | (uint32_t)child_rep[ptn];
+            size_t slot = (pair * 0x9E3779B97F4A7C15ULL) >> (64 - hash_bits);
+            while (site_repeats_hash_key[slot] != UINT64_MAX && site_repeats_hash_key[slot] != pair)
+                slot = (slot+1) & hash_mask;
+            if (site_repeats_hash_key[slot] == UINT64_MAX) {
+                site_repeats_hash_key[slot] = pair;
+                site_repeats_hash_ptn[slot] = ptn;
+            }
+            ptn_rep[ptn] = site_repeats_hash_ptn[slot];
+        }
+    }
+    *rep_key = key;
+}
+
+size_t PhyloTree::getPartialLhEntries() {
     // +num_states for ascertainment bias correction
     size_t block_size = get_safe_upper_limit(aln->size())+max(get_safe_upper_limit(aln->num_states),
         get_safe_upper_limit(model_factory->unobserved_ptns.size()));
@@ -1193,6 +1398,29 @@ size_t PhyloTree::getPartialLhSize() {
     return block_size;
 }
 
+bool PhyloTree::setLikelihoodFloat(bool enable) {
+    if (enable && (sse < LK_SSE2 || !model || !model->useRevKernel() || model->isSiteSpecificModel() || isMixlen()))
+        enable = false;
+    lk_float_underflow = false;
+    if (enable == lk_float)
+        return lk_float;
+    lk_float = enable;
+    if (!central_partial_lh)
+        return lk_float;
+    // reallocate partial likelihood vectors with the new size
+    aligned_free(central_partial_lh);
+    aligned_free(nni_partial_lh);
+    aligned_free(buffer_float_lh);
+    if (params->lh_mem_save == LM_MEM_SAVE)
+        max_lh_slots = 0;
+    initializeAllPartialLh();
+    clearAllPartialLH();
+    if (verbose_mode >= VB_MED)
+        cout << "Partial likelihoods stored in " << (lk_float ? "single" : "double") << " precision ("
+             << (max_lh_slots * getPartialLhSize() * sizeof(double)) / 1048576 << " MB)" << endl;
+    return lk_float;
+}
+
 size_t PhyloTree::getPartialLhBytes() {
     // +num_states for ascertainment bias correction
     return getPartialLhSize() * sizeof(double);
@@ -5910,6 +6138,8 @@ bool PhyloTree::computeTraversalInfo(PhyloNeighbor *dad_branch, PhyloNode *dad,
     PhyloNode *node = (PhyloNode*)dad_branch->node;
 
     if ((dad_branch->partial_lh_computed & 1) || node->isLeaf()) {
+        if (!node->isLeaf())
+            num_partial_lh_reused++;
         return mem_slots.lock(dad_branch);
     }
 
@@ -5991,6 +6221,10 @@ bool PhyloTree::computeTraversalInfo(PhyloNeighbor *dad_branch, PhyloNode *dad,
         //cout << "Branch " << dad->id << "-" << node->id << " assigned slot " << slot_id << endl;
     }
 
+    // children are still locked, their site repeats are valid
+    if (site_repeats && params->lh_mem_save != LM_MEM_SAVE && model->useRevKernel() && !model->isSiteSpecificModel())
+        computeSiteRepeats(dad_branch, dad);
+
     if (params->lh_mem_save == LM_MEM_SAVE) {
         for (it = neivec.begin(); it != neivec.end(); it++) {
             if ((*it)->node != dad) {
@@ -6011,9 +6245,106 @@ bool PhyloTree::computeTraversalInfo(PhyloNeighbor *dad_branch, PhyloNode *dad,
         }
     }
     traversal_info.push_back(info);
+    num_partial_lh_computations++;
     return mem_slots.lock(dad_branch);
 }
 
+struct TraversalTaskGraph {
+    /** pattern boundaries of the blocks */
+    size_t *limits;
+
+    /** number of pattern blocks */
+    int num_blocks;
+
+    /** index of the traversal node waiting for each traversal node, -1 if none */
+    IntVector parent;
+
+    /** number of unfinished children of every (traversal node, block) */
+    IntVector pending;
+};
+
+bool PhyloTree::isTraversalTaskGraph() {
+#if defined(_OPENMP) && _OPENMP >= 201107
+    // with memory saving, later traversal nodes may reuse the slots of earlier ones
+    return params->lk_tasks && num_threads > 1 && traversal_info.size() > 1
+        && params->lh_mem_save != LM_MEM_SAVE;
+#else
+    return false;
+#endif
+}
+
+void PhyloTree::computePartialLikelihoodTasks(vector<size_t> &limits) {
+    int num_info = traversal_info.size();
+    TraversalTaskGraph graph;
+    graph.limits = limits.data();
+    graph.num_blocks = limits.size()-1;
+    graph.parent.assign(num_info, -1);
+    IntVector num_children(num_info, 0);
+
+    // children always precede their dad in traversal_info
+    unordered_map<PhyloNeighbor*, int> info_id;
+    for (int i = 0; i < num_info; i++) {
+        PhyloNode *node = (PhyloNode*)traversal_info[i].dad_branch->node;
+        FOR_NEIGHBOR_IT(node, traversal_info[i].dad, it) {
+            auto child = info_id.find((PhyloNeighbor*)(*it));
+            if (child != info_id.end()) {
+                graph.parent[child->second] = i;
+                num_children[i]++;
+            }
+        }
+        info_id[traversal_info[i].dad_branch] = i;
+    }
+    graph.pending.resize(num_info*graph.num_blocks);
+    for (int i = 0; i < num_info; i++)
+        for (int block = 0; block < graph.num_blocks; block++)
+            graph.pending[i*graph.num_blocks + block] = num_children[i];
+
+    TraversalTaskGraph *graph_ptr = &graph;
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp parallel num_threads(num_threads)
+#pragma omp single
+#endif
+    for (int block = 0; block < graph.num_blocks; block++)
+        for (int i = 0; i < num_info; i++)
+            if (num_children[i] == 0) {
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp task firstprivate(graph_ptr, i, block)
+#endif
+                runPartialLikelihoodTask(graph_ptr, i, block);
+            }
+}
+
+void PhyloTree::runPartialLikelihoodTask(TraversalTaskGraph *graph, int info_id, int block) {
+    // a task never yields, so the kernel buffer of the thread is not shared
+#ifdef _OPENMP
+    int thread_id = omp_get_thread_num();
+#else
+    int thread_id = 0;
+#endif
+    while (info_id >= 0) {
+        computePartialLikelihood(traversal_info[info_id], graph->limits[block], graph->limits[block+1], thread_id);
+        info_id = graph->parent[info_id];
+        if (info_id < 0)
+            break;
+        int pending;
+        // the dad reads what the other children wrote: the decrement has to order memory
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp atomic capture seq_cst
+        pending = --graph->pending[info_id*graph->num_blocks + block];
+#elif defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp flush
+#pragma omp atomic capture
+        pending = --graph->pending[info_id*graph->num_blocks + block];
+#pragma omp flush
+#else
+        pending = --graph->pending[info_id*graph->num_blocks + block];
+#endif
+        // the last finished child carries on with the dad
+        if (pending > 0)
+            break;
+    }
+}
+
 void PhyloTree::writeSiteLh(ostream &out, SiteLoglType wsl, int partid) {
     // error checking
     if (!getModel()->isMixture()) {
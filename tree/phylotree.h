@@ -79,6 +79,12 @@ const double TOL_LIKELIHOOD_PARAMOPT = 0.001; // BQM: newly introduced for Model
 //#define LOG_SCALING_THRESHOLD log(SCALING_THRESHOLD)
 #define LOG_SCALING_THRESHOLD -177.4456782233459932741
 
+// single-precision partial likelihoods (--lk-float): patterns whose largest entry is
+// below 2^{-100} are stored multiplied by 2^{150} to stay clear of float subnormals
+#define FLOAT_LH_BIAS_EXP 150
+// 2^{-100}
+#define FLOAT_LH_BIAS_THRESHOLD 7.888609052210118054117e-31
+
 const int SPR_DEPTH = 2;
 
 //using namespace Eigen;
@@ -330,6 +336,9 @@ public:
     }
 };
 
+/** shared state of PhyloTree::computePartialLikelihoodTasks() */
+struct TraversalTaskGraph;
+
 // ********************************************
 // END traversal information
 // ********************************************
@@ -446,6 +455,12 @@ public:
      */
     void copyPhyloTree(PhyloTree *tree, bool borrowSummary);
 
+    /**
+            borrow the alignment summary of another tree, which keeps ownership of it
+            @param tree the tree that owns the summary
+     */
+    void borrowSummary(PhyloTree *tree);
+
     /**
             copy the phylogenetic tree structure into this tree, designed specifically for PhyloTree.
             So there is some distinction with copyTree.
@@ -594,6 +609,29 @@ public:
      */
     virtual void restoreBranchLengths(DoubleVector &lenvec, int startid = 0, PhyloNode *node = NULL, PhyloNode *dad = NULL);
 
+    /**
+     * clear only those partial likelihoods whose subtree contains a branch with a length
+     * different from lenvec; all other partial likelihoods stay valid
+     * @param lenvec branch lengths from saveBranchLengths() when the partial likelihoods were computed
+     */
+    virtual void clearChangedPartialLh(DoubleVector &lenvec);
+
+    /**
+     * helper for clearChangedPartialLh()
+     * @param lenvec saved branch lengths
+     * @param[out] num_below number of changed branches below each node (by node id)
+     * @return number of changed branches below node incl. the branch to dad
+     */
+    int countChangedBranches(DoubleVector &lenvec, IntVector &num_below, PhyloNode *node, PhyloNode *dad);
+
+    /**
+     * helper for clearChangedPartialLh()
+     * @param lenvec saved branch lengths
+     * @param num_below number of changed branches below each node from countChangedBranches()
+     * @param total total number of changed branches
+     */
+    void clearChangedPartialLh(DoubleVector &lenvec, IntVector &num_below, int total, PhyloNode *node, PhyloNode *dad);
+
     /****************************************************************************
             Dot product
      ****************************************************************************/
@@ -603,6 +641,32 @@ public:
     typedef BootValType (PhyloTree::*DotProductType)(BootValType *x, BootValType *y, int size);
     DotProductType dotProduct;
 
+    /**
+        blocked matrix-vector product res[row] = sum_i x[i]*mat[row*stride+i]:
+        x is processed in tiles that stay in L1 cache and each tile is
+        multiplied with four rows at a time
+        @param x vector, padded with zeros to a multiple of the vector size
+        @param mat first row of the matrix of bootstrap pattern counts, padded like x
+        @param stride distance between two rows of mat
+        @param nrow number of rows
+        @param size length of x
+        @param[out] res nrow dot products
+     */
+    template <class Numeric, class VectorClass, class Count>
+    void dotProductBatchSIMD(Numeric *x, Count *mat, size_t stride, int nrow, int size, double *res);
+
+    typedef void (PhyloTree::*DotProductBatchType)(BootValType *x, float *mat, size_t stride, int nrow, int size, double *res);
+    /** dotProductBatch for counts stored as float */
+    DotProductBatchType dotProductBatch;
+
+    /** dotProductBatch for 8-bit integer counts */
+    typedef void (PhyloTree::*DotProductBatchUInt8Type)(BootValType *x, uint8_t *mat, size_t stride, int nrow, int size, double *res);
+    DotProductBatchUInt8Type dotProductBatchUInt8;
+
+    /** dotProductBatch for 16-bit integer counts */
+    typedef void (PhyloTree::*DotProductBatchUInt16Type)(BootValType *x, uint16_t *mat, size_t stride, int nrow, int size, double *res);
+    DotProductBatchUInt16Type dotProductBatchUInt16;
+
     typedef double (PhyloTree::*DotProductDoubleType)(double *x, double *y, int size);
     DotProductDoubleType dotProductDouble;
 
@@ -694,7 +758,35 @@ public:
 
     template<class VectorClass>
     int computeParsimonyBranchSankoffSIMD(PhyloNeighbor *dad_branch, PhyloNode *dad, int *branch_subst = NULL);
-    
+
+    typedef UINT (PhyloTree::*ComputeParsimonyInsertCostType)(UINT *, UINT *, UINT *, UINT);
+    ComputeParsimonyInsertCostType computeParsimonyInsertCostPointer;
+
+    /**
+            compute the extra parsimony score of attaching a subtree to a branch, without changing the tree
+            @param node_pars Fitch state sets of one side of the branch (partial_pars)
+            @param dad_pars Fitch state sets of the other side of the branch
+            @param subtree_pars Fitch state sets of the attached subtree
+            @param lower_bound stop counting once the score reaches this value
+            @return number of extra substitutions, or a value >= lower_bound
+     */
+    template<class VectorClass>
+    UINT computeParsimonyInsertCostFastSIMD(UINT *node_pars, UINT *dad_pars, UINT *subtree_pars, UINT lower_bound);
+
+    typedef bool (PhyloTree::*ComputeParsimonyStatesType)(UINT *, UINT *, UINT *);
+    ComputeParsimonyStatesType computeParsimonyStatesPointer;
+
+    /**
+            compute the Fitch state sets of a subtree from its two child subtrees;
+            unlike computePartialParsimony() the subtree score is not updated
+            @param left_pars Fitch state sets of the left subtree
+            @param right_pars Fitch state sets of the right subtree
+            @param[in,out] pars Fitch state sets of the subtree
+            @return TRUE if pars changed
+     */
+    template<class VectorClass>
+    bool computeParsimonyStatesFastSIMD(UINT *left_pars, UINT *right_pars, UINT *pars);
+
 //    void printParsimonyStates(PhyloNeighbor *dad_branch = NULL, PhyloNode *dad = NULL);
 
     virtual void setParsimonyKernel(LikelihoodKernel lk);
@@ -703,6 +795,7 @@ public:
 #else
     virtual void setParsimonyKernelAVX();
 #endif
+    void setParsimonyKernelAVX512();
 
     virtual void setParsimonyKernelSSE();
 
@@ -801,6 +894,61 @@ public:
     size_t getPartialLhBytes();
     size_t getPartialLhSize();
 
+    /** @return number of entries of a partial_lh vector, independent of the storage precision */
+    size_t getPartialLhEntries();
+
+    /**
+            switch the storage of partial likelihood vectors between single and double precision;
+            all partial likelihood vectors are reallocated and must be recomputed
+            @param enable TRUE for single precision, only supported for reversible,
+                non-site-specific models without mixture branch lengths and SIMD kernels
+            @return TRUE if single precision is used afterwards
+     */
+    virtual bool setLikelihoodFloat(bool enable);
+
+    /** @return TRUE if partial likelihood vectors are stored in single precision */
+    bool isLikelihoodFloat() {
+        return lk_float;
+    }
+
+    /**
+            @return TRUE if a single-precision partial likelihood vector underflowed
+                since the last call to setLikelihoodFloat()
+     */
+    virtual bool isLikelihoodFloatUnderflown() {
+        return lk_float_underflow;
+    }
+
+    /**
+            @param nei a neighbor with allocated partial_lh
+            @return for every pattern the first pattern with the same states in the subtree
+                below nei, NULL if site repeats are not used
+     */
+    int *getSiteRepeats(PhyloNeighbor *nei);
+
+    /**
+            @param nei a neighbor with allocated partial_lh
+            @return key of the leaf set below nei for which getSiteRepeats(nei) was computed,
+                NULL if site repeats are not used
+     */
+    uint64_t *getSiteRepeatsKey(PhyloNeighbor *nei);
+
+    /**
+            @return a new salt for the site-repeat keys, so that keys left in reallocated
+                partial_lh memory or computed for another alignment never match
+     */
+    static uint64_t newSiteRepeatsSalt();
+
+    /**
+            compute the site-repeat representatives of dad_branch from those of its children;
+            called for every branch put into traversal_info; returns right away if the leaf set
+            below dad_branch is unchanged, so after a tree move only the repeats of the changed
+            subtrees are recomputed
+            @param dad_branch branch whose partial_lh will be computed
+            @param dad its dad node
+     */
+    void computeSiteRepeats(PhyloNeighbor *dad_branch, PhyloNode *dad);
+
     /**
             allocate memory for a scale num vector
      */
@@ -829,6 +977,29 @@ public:
     /** true if using safe numeric for likelihood kernel */
     bool safe_numeric;
 
+    /**
+        true if partial_lh vectors are stored in single precision: a vector then holds
+        getPartialLhEntries() floats followed by one exponent-bias flag per pattern
+     */
+    bool lk_float;
+
+    /** true if a single-precision partial_lh vector was not representable, set atomically by the kernels */
+    bool lk_float_underflow;
+
+    /**
+        true if every partial_lh vector is followed by one int per pattern holding the first
+        pattern with the same states in the subtree (see getSiteRepeats); the kernels then
+        copy instead of compute the partial likelihoods of such repeated patterns
+     */
+    bool site_repeats;
+
+    /** salt of the site-repeat keys of the current partial_lh memory and alignment */
+    uint64_t site_repeats_salt;
+
+    /** buffers of computeSiteRepeats, kept to avoid reallocation */
+    vector<uint64_t> site_repeats_hash_key;
+    vector<int> site_repeats_hash_ptn, site_repeats_tip, site_repeats_state;
+
     /** number of threads used for likelihood kernel */
     int num_threads;
 
@@ -845,6 +1016,29 @@ public:
     */
     bool computeTraversalInfo(PhyloNeighbor *dad_branch, PhyloNode *dad, double* &buffer);
 
+    /**
+        @return TRUE if the partial likelihoods of traversal_info should be computed by
+            computePartialLikelihoodTasks()
+    */
+    bool isTraversalTaskGraph();
+
+    /**
+        compute all partial likelihoods of traversal_info as a task graph: one task per
+        (traversal node, pattern block), which becomes ready once the same pattern block
+        of all its children is done, so that idle threads pick up independent subtrees
+        @param limits pattern boundaries of the blocks, from computeBounds()
+    */
+    void computePartialLikelihoodTasks(vector<size_t> &limits);
+
+    /**
+        run a ready task of computePartialLikelihoodTasks() and continue with the
+        parent node as long as this task finished its last child
+        @param graph task graph
+        @param info_id index into traversal_info
+        @param block pattern block
+    */
+    void runPartialLikelihoodTask(TraversalTaskGraph *graph, int info_id, int block);
+
 
     /**
         compute traversal_info of both subtrees
@@ -1366,6 +1560,60 @@ public:
      */
     int addTaxonMPFast(Node *added_taxon, Node *added_node, Node *node, Node *dad);
 
+    /**
+            INCREMENTAL VERSION: add the remaining taxa by stepwise addition, used internally by
+            computeParsimonyTree(). The state sets of both directions of all branches are kept,
+            so every target branch is scored by one pass of computeParsimonyInsertCostPointer
+            and an insertion only recomputes the state sets it changes.
+            @param taxon_order taxon addition order, the first leafNum taxa are in the tree
+            @param[in,out] index index of the next free partial_pars block
+            @param[in,out] newNodeID ID of the next internal node
+            @return parsimony score of the final tree
+     */
+    int addTaxaMPIncremental(IntVector &taxon_order, size_t &index, int &newNodeID);
+
+    /**
+            recompute the state sets of the subtrees containing dad after they changed at
+            node->findNeighbor(dad), stopping where they do not change any more
+            @param node the current node
+            @param dad the neighbor of node in direction of the change
+     */
+    void updateParsimonyStates(PhyloNode *node, PhyloNode *dad);
+
+    /**
+            improve the tree by parsimony SPR moves until no move within the radius reduces
+            the parsimony score. Uses the state sets of both directions of all branches like
+            addTaxaMPIncremental(), branch lengths of moved branches are reset.
+            @param radius maximum number of branches between the pruned and regrafted positions
+            @return parsimony score of the improved tree
+     */
+    int optimizeParsimonySPR(int radius);
+
+    /**
+            prune the subtree at node together with dad and regraft it on the branch
+            that reduces the parsimony score most, used internally by optimizeParsimonySPR()
+            @param node root of the pruned subtree
+            @param dad internal node attaching the subtree to the rest of the tree
+            @param buffers spr_radius temporary state set blocks
+            @return reduction of the parsimony score, 0 if the tree is unchanged
+     */
+    UINT moveParsimonySPR(PhyloNode *node, PhyloNode *dad, vector<UINT*> &buffers);
+
+    /**
+            score the regraft branches below node within spr_radius, used internally by moveParsimonySPR()
+            @param node the current node
+            @param dad dad of the node, used to direct the search
+            @param dad_pars state sets on dad's side of node, without the pruned subtree
+            @param subtree_pars state sets of the pruned subtree
+            @param depth index of buffers for the branches below node
+            @param buffers spr_radius temporary state set blocks
+            @param[in,out] best_cost lowest insertion cost found
+            @param[out] best_node one end of the best regraft branch, away from the pruned position
+            @param[out] best_dad the other end of the best regraft branch
+     */
+    void scanParsimonySPR(PhyloNode *node, PhyloNode *dad, UINT *dad_pars, UINT *subtree_pars, int depth,
+            vector<UINT*> &buffers, UINT &best_cost, PhyloNode *&best_node, PhyloNode *&best_dad);
+
     /**
         create a 3-taxon tree and return random taxon order
         @param[out] taxon_order random taxon order
@@ -1540,6 +1788,9 @@ public:
     /** buffer used when computing partial_lh, to avoid repeated mem allocation */
     double *buffer_partial_lh;
 
+    /** per-packet double buffers to load and store single-precision partial_lh (see lk_float) */
+    double *buffer_float_lh;
+
     /**
      * frequencies of alignment patterns, used as buffer for likelihood computation
      */
@@ -2120,6 +2371,18 @@ public:
 
 	size_t num_partial_lh_computations;
 
+    /** number of partial likelihood vectors found valid and reused when preparing a traversal */
+    size_t num_partial_lh_reused;
+
+    /**
+        @param[out] computed number of partial likelihood vectors computed so far
+        @param[out] reused number of partial likelihood vectors reused so far
+     */
+    virtual void getPartialLhCounters(size_t &computed, size_t &reused) {
+        computed = num_partial_lh_computations;
+        reused = num_partial_lh_reused;
+    }
+
 	/** remove identical sequences from the tree */
     virtual void removeIdenticalSeqs(Params &params);
 
@@ -36,13 +36,21 @@ void PhyloTree::setParsimonyKernelAVX() {
     // Fitch kernel
 	computeParsimonyBranchPointer = &PhyloTree::computeParsimonyBranchFastSIMD<Vec8ui>;
     computePartialParsimonyPointer = &PhyloTree::computePartialParsimonyFastSIMD<Vec8ui>;
+    computeParsimonyInsertCostPointer = &PhyloTree::computeParsimonyInsertCostFastSIMD<Vec8ui>;
+    computeParsimonyStatesPointer = &PhyloTree::computeParsimonyStatesFastSIMD<Vec8ui>;
 }
 
 void PhyloTree::setDotProductAVX() {
 #ifdef BOOT_VAL_FLOAT
 		dotProduct = &PhyloTree::dotProductSIMD<float, Vec8f>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<float, Vec8f, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<float, Vec8f, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<float, Vec8f, uint16_t>;
 #else
 		dotProduct = &PhyloTree::dotProductSIMD<double, Vec4d>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<double, Vec4d, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<double, Vec4d, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<double, Vec4d, uint16_t>;
 #endif
         dotProductDouble = &PhyloTree::dotProductSIMD<double, Vec4d>;
 }
@@ -1174,7 +1174,10 @@ int PhyloTree::computeParsimonyTree(const char *out_prefix, Alignment *alignment
     if (leafNum == nseq) {
         outWarning("Constraint tree has all taxa and is bifurcating, which strictly enforces final tree!");
     }
-    
+
+    if (constraintTree.empty() && computeParsimonyInsertCostPointer && Params::getInstance().pars_incremental)
+        best_pars_score = addTaxaMPIncremental(taxon_order, index, newNodeID);
+
     // stepwise adding the next taxon for the remaining taxa
     for (int step = 0; leafNum < nseq; step++) {
         NodeVector nodes1, nodes2;
@@ -1244,6 +1247,9 @@ int PhyloTree::computeParsimonyTree(const char *out_prefix, Alignment *alignment
     
     ASSERT(index == 4*leafNum-6);
 
+    if (constraintTree.empty() && computeParsimonyStatesPointer && Params::getInstance().pars_spr)
+        best_pars_score = optimizeParsimonySPR(Params::getInstance().sprDist);
+
     nodeNum = 2 * leafNum - 2;
     initializeTree();
     // parsimony tree is always unrooted
@@ -1294,6 +1300,223 @@ int PhyloTree::addTaxonMPFast(Node *added_taxon, Node* added_node, Node* node, N
 
 }
 
+int PhyloTree::addTaxaMPIncremental(IntVector &taxon_order, size_t &index, int &newNodeID) {
+    size_t nseq = aln->getNSeq();
+    size_t pars_block_size = getBitsBlockSize();
+
+    // state sets of both directions of every branch
+    NodeVector nodes1, nodes2;
+    getBranches(nodes1, nodes2);
+    for (int i = 0; i < nodes1.size(); i++) {
+        computePartialParsimony((PhyloNeighbor*)nodes1[i]->findNeighbor(nodes2[i]), (PhyloNode*)nodes1[i]);
+        computePartialParsimony((PhyloNeighbor*)nodes2[i]->findNeighbor(nodes1[i]), (PhyloNode*)nodes2[i]);
+    }
+    int score = computeParsimony();
+
+    while (leafNum < nseq) {
+        if (verbose_mode >= VB_MAX)
+            cout << "Adding " << aln->getSeqName(taxon_order[leafNum]) << " to the tree..." << endl;
+        nodes1.clear();
+        nodes2.clear();
+        getBranches(nodes1, nodes2);
+
+        // create a new taxon attached to a new node like computeParsimonyTree()
+        PhyloNode *added_node = (PhyloNode*)newNode(newNodeID++);
+        PhyloNode *new_taxon = (PhyloNode*)newNode(taxon_order[leafNum], aln->getSeqName(taxon_order[leafNum]).c_str());
+        added_node->addNeighbor(new_taxon, -1.0);
+        new_taxon->addNeighbor(added_node, -1.0);
+        PhyloNeighbor *taxon_nei = (PhyloNeighbor*)new_taxon->findNeighbor(added_node);
+        PhyloNeighbor *added_taxon_nei = (PhyloNeighbor*)added_node->findNeighbor(new_taxon);
+        taxon_nei->partial_pars = central_partial_pars + ((index++) * pars_block_size);
+        added_taxon_nei->partial_pars = central_partial_pars + ((index++) * pars_block_size);
+        computePartialParsimony(added_taxon_nei, added_node);
+
+        // find the best target branch
+        UINT best_cost = UINT_MAX;
+        PhyloNode *target_node = NULL;
+        PhyloNode *target_dad = NULL;
+        for (int i = 0; i < nodes1.size(); i++) {
+            UINT cost = (this->*computeParsimonyInsertCostPointer)(
+                ((PhyloNeighbor*)nodes1[i]->findNeighbor(nodes2[i]))->partial_pars,
+                ((PhyloNeighbor*)nodes2[i]->findNeighbor(nodes1[i]))->partial_pars,
+                added_taxon_nei->partial_pars, best_cost);
+            if (cost < best_cost) {
+                best_cost = cost;
+                target_node = (PhyloNode*)nodes1[i];
+                target_dad = (PhyloNode*)nodes2[i];
+            }
+        }
+        score += best_cost;
+        if (verbose_mode >= VB_MAX)
+            cout << ", score = " << score << endl;
+
+        // insert the new node, the subtrees of target_node and target_dad keep their state sets
+        added_node->addNeighbor((Node*) 1, -1.0);
+        added_node->addNeighbor((Node*) 2, -1.0);
+        insertNode2Branch(added_node, target_node, target_dad);
+        PhyloNeighbor *dad_nei = (PhyloNeighbor*)target_dad->findNeighbor(added_node);
+        PhyloNeighbor *node_nei = (PhyloNeighbor*)target_node->findNeighbor(added_node);
+        dad_nei->partial_pars = central_partial_pars + ((index++) * pars_block_size);
+        node_nei->partial_pars = central_partial_pars + ((index++) * pars_block_size);
+
+        UINT *node_pars = ((PhyloNeighbor*)added_node->findNeighbor(target_node))->partial_pars;
+        UINT *dad_pars = ((PhyloNeighbor*)added_node->findNeighbor(target_dad))->partial_pars;
+        (this->*computeParsimonyStatesPointer)(dad_pars, added_taxon_nei->partial_pars, node_nei->partial_pars);
+        (this->*computeParsimonyStatesPointer)(node_pars, added_taxon_nei->partial_pars, dad_nei->partial_pars);
+        (this->*computeParsimonyStatesPointer)(node_pars, dad_pars, taxon_nei->partial_pars);
+
+        // only the subtrees now containing the new taxon change
+        updateParsimonyStates(target_node, added_node);
+        updateParsimonyStates(target_dad, added_node);
+        leafNum++;
+    }
+
+    // the subtree scores in partial_pars were not maintained
+    clearAllPartialLH();
+    return score;
+}
+
+void PhyloTree::updateParsimonyStates(PhyloNode *node, PhyloNode *dad) {
+    UINT *dad_pars = ((PhyloNeighbor*)node->findNeighbor(dad))->partial_pars;
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        PhyloNode *child = (PhyloNode*)(*it)->node;
+        UINT *other_pars = NULL;
+        FOR_NEIGHBOR_IT(node, dad, it2)
+            if ((*it2)->node != child)
+                other_pars = ((PhyloNeighbor*)(*it2))->partial_pars;
+        ASSERT(other_pars);
+        UINT *pars = ((PhyloNeighbor*)child->findNeighbor(node))->partial_pars;
+        if ((this->*computeParsimonyStatesPointer)(dad_pars, other_pars, pars))
+            updateParsimonyStates(child, node);
+    }
+}
+
+int PhyloTree::optimizeParsimonySPR(int radius) {
+    if (radius <= 0 || leafNum < 4)
+        return computeParsimony();
+    spr_radius = radius;
+
+    // state sets of both directions of every branch
+    clearAllPartialLH();
+    NodeVector nodes1, nodes2;
+    getBranches(nodes1, nodes2);
+    for (int i = 0; i < nodes1.size(); i++) {
+        computePartialParsimony((PhyloNeighbor*)nodes1[i]->findNeighbor(nodes2[i]), (PhyloNode*)nodes1[i]);
+        computePartialParsimony((PhyloNeighbor*)nodes2[i]->findNeighbor(nodes1[i]), (PhyloNode*)nodes2[i]);
+    }
+    int score = computeParsimony();
+
+    vector<UINT*> buffers(spr_radius);
+    for (int i = 0; i < spr_radius; i++)
+        buffers[i] = newBitsBlock();
+
+    NodeVector nodes;
+    getInternalNodes(nodes);
+    int round;
+    for (round = 1; ; round++) {
+        int old_score = score;
+        for (NodeVector::iterator it = nodes.begin(); it != nodes.end(); it++)
+            for (int i = 0; i < (*it)->neighbors.size(); i++)
+                score -= moveParsimonySPR((PhyloNode*)(*it)->neighbors[i]->node, (PhyloNode*)(*it), buffers);
+        if (verbose_mode >= VB_MAX)
+            cout << "Parsimony SPR round " << round << ": score = " << score << endl;
+        if (score == old_score)
+            break;
+    }
+
+    for (int i = spr_radius-1; i >= 0; i--)
+        aligned_free(buffers[i]);
+    // the subtree scores in partial_pars were not maintained
+    clearAllPartialLH();
+    if (verbose_mode >= VB_MED)
+        cout << "Parsimony SPR (radius " << spr_radius << ") took " << round << " rounds, score = " << score << endl;
+    return score;
+}
+
+UINT PhyloTree::moveParsimonySPR(PhyloNode *node, PhyloNode *dad, vector<UINT*> &buffers) {
+    PhyloNeighbor *dad_nei1 = NULL;
+    PhyloNeighbor *dad_nei2 = NULL;
+    FOR_NEIGHBOR_IT(dad, node, it) {
+        if (!dad_nei1)
+            dad_nei1 = (PhyloNeighbor*)(*it);
+        else
+            dad_nei2 = (PhyloNeighbor*)(*it);
+    }
+    ASSERT(dad_nei2);
+    PhyloNode *sibling1 = (PhyloNode*)dad_nei1->node;
+    PhyloNode *sibling2 = (PhyloNode*)dad_nei2->node;
+    UINT *subtree_pars = ((PhyloNeighbor*)dad->findNeighbor(node))->partial_pars;
+
+    // the subtree currently sits on the branch sibling1-sibling2 of the pruned tree
+    UINT removal_cost = (this->*computeParsimonyInsertCostPointer)(
+        dad_nei1->partial_pars, dad_nei2->partial_pars, subtree_pars, UINT_MAX);
+    if (removal_cost == 0)
+        return 0;
+    UINT best_cost = removal_cost;
+    PhyloNode *target_node = NULL;
+    PhyloNode *target_dad = NULL;
+    scanParsimonySPR(sibling1, dad, dad_nei2->partial_pars, subtree_pars, 0, buffers, best_cost, target_node, target_dad);
+    scanParsimonySPR(sibling2, dad, dad_nei1->partial_pars, subtree_pars, 0, buffers, best_cost, target_node, target_dad);
+    if (!target_node)
+        return 0;
+
+    // prune: join the siblings, which keep the state sets away from dad
+    UINT *free_pars1 = ((PhyloNeighbor*)sibling1->findNeighbor(dad))->partial_pars;
+    UINT *free_pars2 = ((PhyloNeighbor*)sibling2->findNeighbor(dad))->partial_pars;
+    sibling1->updateNeighbor(dad, sibling2, -1.0);
+    sibling2->updateNeighbor(dad, sibling1, -1.0);
+    ((PhyloNeighbor*)sibling1->findNeighbor(sibling2))->partial_pars = dad_nei2->partial_pars;
+    ((PhyloNeighbor*)sibling2->findNeighbor(sibling1))->partial_pars = dad_nei1->partial_pars;
+    updateParsimonyStates(sibling1, sibling2);
+    updateParsimonyStates(sibling2, sibling1);
+
+    // regraft dad on the branch target_node-target_dad, like addTaxaMPIncremental()
+    PhyloNeighbor *node_nei = (PhyloNeighbor*)target_node->findNeighbor(target_dad);
+    PhyloNeighbor *dad_nei = (PhyloNeighbor*)target_dad->findNeighbor(target_node);
+    dad_nei1->node = target_node;
+    dad_nei1->length = -1.0;
+    dad_nei2->node = target_dad;
+    dad_nei2->length = -1.0;
+    target_node->updateNeighbor(target_dad, dad, -1.0);
+    target_dad->updateNeighbor(target_node, dad, -1.0);
+    dad_nei1->partial_pars = dad_nei->partial_pars;
+    dad_nei2->partial_pars = node_nei->partial_pars;
+    node_nei->partial_pars = free_pars1;
+    dad_nei->partial_pars = free_pars2;
+
+    (this->*computeParsimonyStatesPointer)(dad_nei2->partial_pars, subtree_pars, node_nei->partial_pars);
+    (this->*computeParsimonyStatesPointer)(dad_nei1->partial_pars, subtree_pars, dad_nei->partial_pars);
+    (this->*computeParsimonyStatesPointer)(dad_nei1->partial_pars, dad_nei2->partial_pars,
+        ((PhyloNeighbor*)node->findNeighbor(dad))->partial_pars);
+    updateParsimonyStates(target_node, dad);
+    updateParsimonyStates(target_dad, dad);
+    updateParsimonyStates(node, dad);
+    return removal_cost - best_cost;
+}
+
+void PhyloTree::scanParsimonySPR(PhyloNode *node, PhyloNode *dad, UINT *dad_pars, UINT *subtree_pars, int depth,
+        vector<UINT*> &buffers, UINT &best_cost, PhyloNode *&best_node, PhyloNode *&best_dad) {
+    FOR_NEIGHBOR_IT(node, dad, it) {
+        PhyloNode *child = (PhyloNode*)(*it)->node;
+        UINT *other_pars = NULL;
+        FOR_NEIGHBOR_IT(node, dad, it2)
+            if ((*it2)->node != child)
+                other_pars = ((PhyloNeighbor*)(*it2))->partial_pars;
+        ASSERT(other_pars);
+        // state sets on node's side of the branch node-child, without the pruned subtree
+        (this->*computeParsimonyStatesPointer)(dad_pars, other_pars, buffers[depth]);
+        UINT cost = (this->*computeParsimonyInsertCostPointer)(
+            ((PhyloNeighbor*)(*it))->partial_pars, buffers[depth], subtree_pars, best_cost);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_node = child;
+            best_dad = node;
+        }
+        if (depth+1 < spr_radius)
+            scanParsimonySPR(child, node, buffers[depth], subtree_pars, depth+1, buffers, best_cost, best_node, best_dad);
+    }
+}
+
 void PhyloTree::extractBifurcatingSubTree(NeighborVec &removed_nei, NodeVector &attached_node, int *rand_stream) {
     NodeVector nodes;
     getMultifurcatingNodes(nodes);
@@ -52,7 +52,10 @@ void PhyloTree::setNumThreads(int threadCount) {
 }
 
 void PhyloTree::setParsimonyKernel(LikelihoodKernel lk) {
-    
+    // only the SIMD Fitch kernels support incremental stepwise addition
+    computeParsimonyInsertCostPointer = NULL;
+    computeParsimonyStatesPointer = NULL;
+
     if (cost_matrix) {
         // Sankoff parsimony kernel
         if (lk < LK_SSE2) {
@@ -77,6 +80,12 @@ void PhyloTree::setParsimonyKernel(LikelihoodKernel lk) {
         computePartialParsimonyPointer = &PhyloTree::computePartialParsimonyFast;
     	return;
     }
+#ifdef __AVX512KNL
+    if (lk >= LK_AVX512) {
+        setParsimonyKernelAVX512();
+        return;
+    }
+#endif
     if (lk >= LK_AVX) {
         setParsimonyKernelAVX();
         return;
@@ -119,6 +128,9 @@ void PhyloTree::setLikelihoodKernel(LikelihoodKernel lk) {
 //		dotProduct = &PhyloTree::dotProductSIMD<float, Vec1f>;
 #else
 		dotProduct = &PhyloTree::dotProductSIMD<double, Vec1d>;
+		dotProductBatch = &PhyloTree::dotProductBatchSIMD<double, Vec1d, float>;
+		dotProductBatchUInt8 = &PhyloTree::dotProductBatchSIMD<double, Vec1d, uint8_t>;
+		dotProductBatchUInt16 = &PhyloTree::dotProductBatchSIMD<double, Vec1d, uint16_t>;
 #endif
         dotProductDouble = &PhyloTree::dotProductSIMD<double, Vec1d>;
 #endif
@@ -1446,7 +1458,7 @@ void PhyloTree::initMarginalAncestralState(ostream &out, bool &orig_kernel_nonre
         setLikelihoodKernel(sse);
         clearAllPartialLH();
     }
-    _pattern_lh_cat_state = newPartialLh();
+    _pattern_lh_cat_state = aligned_alloc<double>(getPartialLhEntries());
 
     size_t nptn = getAlnNPattern();
     size_t nstates = model->num_states;
@@ -37,6 +37,10 @@
 #define BOOT_TAG 3 // Message to please send bootstrap trees
 #define BOOT_TREE_TAG 4 // bootstrap tree tag
 #define LOGL_CUTOFF_TAG 5 // send logl_cutoff for ultrafast bootstrap
+#define MF_JOB_TAG 6 // ModelFinder job for a worker
+#define MF_RESULT_TAG 7 // result of a ModelFinder job, also used to request the next job
+#define BOOT_JOB_TAG 8 // bootstrap replicate for a worker
+#define BOOT_RESULT_TAG 9 // tree of a bootstrap replicate, also used to request the next replicate
 
 using namespace std;
 
@@ -31,6 +31,21 @@ Checkpoint::~Checkpoint() {
 
 void Checkpoint::setFileName(string filename) {
 	this->filename = filename;
+    if (binary_log.isEnabled())
+        binary_log.setFileName(getBinaryFileName());
+}
+
+void Checkpoint::setBinary(bool binary) {
+    binary_log.setFileName(binary ? getBinaryFileName() : "");
+}
+
+string Checkpoint::getBinaryFileName() {
+    if (filename.empty())
+        return "";
+    string name = filename;
+    if (name.length() > 3 && name.substr(name.length()-3) == ".gz")
+        name.erase(name.length()-3);
+    return name + ".bin";
 }
 
 
@@ -75,6 +90,12 @@ void Checkpoint::load(istream &in) {
 
 bool Checkpoint::load() {
 	ASSERT(filename != "");
+    if (binary_log.isEnabled() && fileExists(binary_log.getFileName())) {
+        if (binary_log.load(*this))
+            return true;
+        outWarning("Ignore invalid binary checkpoint file " + binary_log.getFileName());
+        clear();
+    }
     if (!fileExists(filename)) return false;
     try {
         igzstream in;
@@ -151,6 +172,11 @@ void Checkpoint::dump(bool force) {
         return;
     }
     prev_dump_time = getRealTime();
+    if (binary_log.isEnabled()) {
+        // only the entries changed since the last dump go to the background writer
+        binary_log.append(*this);
+        return;
+    }
     string filename_tmp = filename + ".tmp";
     if (fileExists(filename_tmp)) {
         outWarning("IQ-TREE was killed while writing temporary checkpoint file " + filename_tmp);
@@ -215,6 +241,270 @@ void Checkpoint::dump(bool force) {
     }
 }
 
+/*-------------------------------------------------------------
+ * binary checkpoint log
+ *-------------------------------------------------------------*/
+
+CheckpointBinaryLog::CheckpointBinaryLog() {
+    live_bytes = 0;
+    file_bytes = 0;
+    need_compact = true;
+    busy = false;
+    stopping = false;
+}
+
+CheckpointBinaryLog::~CheckpointBinaryLog() {
+    if (!writer.joinable())
+        return;
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    work_cond.notify_one();
+    writer.join();
+    if (!error.empty())
+        outWarning(error);
+}
+
+void CheckpointBinaryLog::setFileName(string filename) {
+    flush();
+    this->filename = filename;
+}
+
+/** append a fixed-size integer in native byte order */
+template <class T>
+static inline void encodeInt(string &out, T value) {
+    out.append((const char*)&value, sizeof(T));
+}
+
+/** read a fixed-size integer, @return FALSE if the buffer is too short */
+template <class T>
+static inline bool decodeInt(const string &in, size_t &pos, T &value) {
+    if (pos + sizeof(T) > in.length())
+        return false;
+    memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+template <class Iterator>
+void CheckpointBinaryLog::encode(Iterator first, Iterator last, string &out) {
+    uint64_t num = 0;
+    for (Iterator it = first; it != last; it++, num++) {
+        out.push_back(it->type);
+        encodeInt(out, (uint32_t)it->key.length());
+        out.append(it->key);
+        if (it->type == 'P') {
+            encodeInt(out, (uint64_t)it->value.length());
+            out.append(it->value);
+        }
+    }
+    out.push_back('C');
+    encodeInt(out, num);
+}
+
+bool CheckpointBinaryLog::load(map<string, string> &ckp) {
+    flush();
+    string data;
+    FILE *in = fopen(filename.c_str(), "rb");
+    if (!in)
+        return false;
+    char buf[1 << 16];
+    size_t num;
+    while ((num = fread(buf, 1, sizeof(buf), in)) > 0)
+        data.append(buf, num);
+    fclose(in);
+
+    size_t pos = strlen(CKP_BIN_MAGIC);
+    uint32_t version;
+    if (data.compare(0, pos, CKP_BIN_MAGIC) != 0 || !decodeInt(data, pos, version) || version != CKP_BIN_VERSION)
+        return false;
+    size_t committed = pos;
+    Batch batch;
+    // apply batches up to the last commit marker, a torn tail is dropped
+    while (pos < data.length()) {
+        Record rec;
+        rec.type = data[pos++];
+        if (rec.type == 'C') {
+            uint64_t num_records;
+            if (!decodeInt(data, pos, num_records) || num_records != batch.size())
+                break;
+            for (Batch::iterator it = batch.begin(); it != batch.end(); it++)
+                if (it->type == 'P')
+                    ckp[it->key].swap(it->value);
+                else
+                    ckp.erase(it->key);
+            batch.clear();
+            committed = pos;
+            continue;
+        }
+        uint32_t key_len;
+        uint64_t value_len = 0;
+        if ((rec.type != 'P' && rec.type != 'E') || !decodeInt(data, pos, key_len) || pos + key_len > data.length())
+            break;
+        rec.key = data.substr(pos, key_len);
+        pos += key_len;
+        if (rec.type == 'P') {
+            if (!decodeInt(data, pos, value_len) || pos + value_len > data.length())
+                break;
+            rec.value = data.substr(pos, value_len);
+            pos += value_len;
+        }
+        batch.push_back(rec);
+    }
+
+    dumped = ckp;
+    disk_state = ckp;
+    live_bytes = 0;
+    for (map<string, string>::iterator it = disk_state.begin(); it != disk_state.end(); it++)
+        live_bytes += it->first.length() + it->second.length();
+    file_bytes = committed;
+    need_compact = (committed != data.length());
+    return true;
+}
+
+void CheckpointBinaryLog::append(map<string, string> &ckp) {
+    if (!isEnabled())
+        return;
+    // merge the sorted entries against the previous dump
+    Batch batch;
+    map<string, string>::iterator it = ckp.begin(), dit = dumped.begin();
+    while (it != ckp.end() || dit != dumped.end()) {
+        if (dit == dumped.end() || (it != ckp.end() && it->first < dit->first)) {
+            Record rec = {'P', it->first, it->second};
+            batch.push_back(rec);
+            dumped.insert(dit, *it);
+            it++;
+        } else if (it == ckp.end() || dit->first < it->first) {
+            Record rec = {'E', dit->first, ""};
+            batch.push_back(rec);
+            dit = dumped.erase(dit);
+        } else {
+            if (it->second != dit->second) {
+                Record rec = {'P', it->first, it->second};
+                batch.push_back(rec);
+                dit->second = it->second;
+            }
+            it++;
+            dit++;
+        }
+    }
+    if (batch.empty() && writer.joinable())
+        return;
+
+    unique_lock<mutex> guard(lock);
+    if (!error.empty()) {
+        string msg = error;
+        error.clear();
+        guard.unlock();
+        outError(msg);
+    }
+    pending.push_back(Batch());
+    pending.back().swap(batch);
+    if (!writer.joinable())
+        writer = thread(&CheckpointBinaryLog::run, this);
+    guard.unlock();
+    work_cond.notify_one();
+}
+
+void CheckpointBinaryLog::flush() {
+    if (!writer.joinable())
+        return;
+    unique_lock<mutex> guard(lock);
+    while (busy || !pending.empty())
+        idle_cond.wait(guard);
+}
+
+void CheckpointBinaryLog::run() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        while (!stopping && pending.empty())
+            work_cond.wait(guard);
+        if (pending.empty())
+            break;
+        Batch batch;
+        batch.swap(pending.front());
+        pending.pop_front();
+        busy = true;
+        guard.unlock();
+        writeBatch(batch);
+        guard.lock();
+        busy = false;
+        idle_cond.notify_all();
+    }
+}
+
+void CheckpointBinaryLog::writeBatch(Batch &batch) {
+    for (Batch::iterator it = batch.begin(); it != batch.end(); it++) {
+        map<string, string>::iterator dit = disk_state.find(it->key);
+        if (dit != disk_state.end()) {
+            live_bytes -= dit->first.length() + dit->second.length();
+            if (it->type == 'E') {
+                disk_state.erase(dit);
+                continue;
+            }
+            dit->second = it->value;
+        } else if (it->type == 'P') {
+            disk_state[it->key] = it->value;
+        } else {
+            continue;
+        }
+        live_bytes += it->key.length() + it->value.length();
+    }
+    if (need_compact || file_bytes > 2*live_bytes + (1 << 20)) {
+        compact();
+        return;
+    }
+    string out;
+    encode(batch.begin(), batch.end(), out);
+    FILE *file = fopen(filename.c_str(), "ab");
+    bool ok = file && fwrite(out.data(), 1, out.length(), file) == out.length();
+    if (file && fclose(file) != 0)
+        ok = false;
+    if (!ok) {
+        unique_lock<mutex> guard(lock);
+        error = "Cannot write binary checkpoint file " + filename;
+        need_compact = true;
+        return;
+    }
+    file_bytes += out.length();
+}
+
+void CheckpointBinaryLog::compact() {
+    struct Entry {
+        char type;
+        const string &key;
+        const string &value;
+    };
+    vector<Entry> entries;
+    entries.reserve(disk_state.size());
+    for (map<string, string>::iterator it = disk_state.begin(); it != disk_state.end(); it++) {
+        Entry entry = {'P', it->first, it->second};
+        entries.push_back(entry);
+    }
+    string out = CKP_BIN_MAGIC;
+    encodeInt(out, CKP_BIN_VERSION);
+    encode(entries.begin(), entries.end(), out);
+
+    string filename_tmp = filename + ".tmp";
+    FILE *file = fopen(filename_tmp.c_str(), "wb");
+    bool ok = file && fwrite(out.data(), 1, out.length(), file) == out.length();
+    if (file && fclose(file) != 0)
+        ok = false;
+    if (ok) {
+        std::remove(filename.c_str());
+        ok = (std::rename(filename_tmp.c_str(), filename.c_str()) == 0);
+    }
+    if (!ok) {
+        unique_lock<mutex> guard(lock);
+        error = "Cannot write binary checkpoint file " + filename;
+        need_compact = true;
+        return;
+    }
+    file_bytes = out.length();
+    need_compact = false;
+}
+
 bool Checkpoint::hasKey(string key) {
 	return (find(struct_name + key) != end());
 }
@@ -15,6 +15,10 @@
 #include <cassert>
 #include <vector>
 #include <typeinfo>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "tools.h"
 
 using namespace std;
@@ -59,6 +63,139 @@ public:
 //    return is;
 //}
 
+/** magic string at the start of a binary checkpoint file */
+#define CKP_BIN_MAGIC "IQCKPBIN"
+
+/** version of the binary checkpoint format, increase whenever the layout changes */
+const uint32_t CKP_BIN_VERSION = 1;
+
+/**
+    Append-only binary checkpoint log written by a background thread.
+
+    The file starts with CKP_BIN_MAGIC and CKP_BIN_VERSION, followed by batches of
+    records in native byte order: 'P' key value (put), 'E' key (erase), terminated by
+    'C' num_records (commit). Keys are prefixed by a 32-bit, values by a 64-bit length.
+    Loading applies only committed batches, so a batch torn by a crash is ignored.
+    Each dump appends the keys changed since the previous dump; the writer compacts
+    the file into one batch once it grows beyond twice the size of the live entries.
+
+    Copies of a Checkpoint do not inherit the log, which stays disabled for them.
+*/
+class CheckpointBinaryLog {
+public:
+
+    /** one record of a batch */
+    struct Record {
+        /** 'P' to put, 'E' to erase the key */
+        char type;
+        string key;
+        string value;
+    };
+
+    typedef vector<Record> Batch;
+
+    CheckpointBinaryLog();
+
+    /** the log of the source is not copied */
+    CheckpointBinaryLog(const CheckpointBinaryLog &) : CheckpointBinaryLog() {}
+
+    /** the log of the source is not copied */
+    CheckpointBinaryLog &operator=(const CheckpointBinaryLog &) { return *this; }
+
+    /** wait for all pending batches and stop the writer thread */
+    ~CheckpointBinaryLog();
+
+    /**
+        enable or disable the log
+        @param filename binary checkpoint file name, empty to disable
+     */
+    void setFileName(string filename);
+
+    /** @return binary checkpoint file name */
+    string &getFileName() { return filename; }
+
+    /** @return TRUE if the log is enabled */
+    bool isEnabled() { return !filename.empty(); }
+
+    /**
+        load all committed batches of the binary checkpoint file
+        @param[out] ckp checkpoint entries
+        @return FALSE if the file does not exist or is not a binary checkpoint
+     */
+    bool load(map<string, string> &ckp);
+
+    /**
+        hand the entries changed since the previous call over to the writer thread;
+        this only compares the entries in memory and never waits for disk I/O
+        @param ckp current checkpoint entries
+     */
+    void append(map<string, string> &ckp);
+
+    /** wait until the writer thread has written all pending batches */
+    void flush();
+
+protected:
+
+    /** main loop of the writer thread */
+    void run();
+
+    /**
+        write one batch into the file (writer thread)
+        @param batch changed entries
+     */
+    void writeBatch(Batch &batch);
+
+    /**
+        rewrite the whole file as a single batch of disk_state (writer thread)
+     */
+    void compact();
+
+    /**
+        serialize records and a commit marker
+        @param first first record
+        @param last after the last record
+        @param[out] out bytes to write
+     */
+    template <class Iterator>
+    static void encode(Iterator first, Iterator last, string &out);
+
+    /** binary checkpoint file name */
+    string filename;
+
+    /** entries as of the last append(), owned by the search thread */
+    map<string, string> dumped;
+
+    /** entries as stored in the file, owned by the writer thread */
+    map<string, string> disk_state;
+
+    /** total size of keys and values of disk_state */
+    size_t live_bytes;
+
+    /** size of the file */
+    size_t file_bytes;
+
+    /** TRUE if the file must be rewritten before appending (new run or torn tail) */
+    bool need_compact;
+
+    /** batches waiting for the writer */
+    deque<Batch> pending;
+
+    /** TRUE while the writer thread writes a batch */
+    bool busy;
+
+    /** TRUE to stop the writer thread */
+    bool stopping;
+
+    /** error message of the writer thread, reported by the search thread */
+    string error;
+
+    thread writer;
+
+    mutex lock;
+
+    condition_variable work_cond, idle_cond;
+};
+
 /**
  * Checkpoint as map from key strings to value strings
  */
@@ -78,6 +215,15 @@ public:
 
     string &getFileName() { return filename; }
 
+    /**
+        write the checkpoint as an append-only binary log instead of a gzipped text file
+        @param binary TRUE to enable the binary log
+    */
+    void setBinary(bool binary);
+
+    /** @return name of the binary checkpoint file of this checkpoint */
+    string getBinaryFileName();
+
     /** 
         set compression for checkpoint file
         @param compression true to compress checkpoint file, or false: no compression 
@@ -456,6 +602,9 @@ protected:
     
     /** header line of checkpoint file */
     string header;
+
+    /** binary log, enabled by setBinary() */
+    CheckpointBinaryLog binary_log;
     
 private:
 
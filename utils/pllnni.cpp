@@ -911,13 +911,10 @@ void pllSaveCurrentTree(pllInstance* tr, partitionList *pr, nodeptr p){
 	}
 	else {
 		// online bootstrap
-		int nptn = pllUFBootDataPtr->n_patterns;
 		int updated = 0;
 		int nsamples = globalParams->gbo_replicates;
 		for (int sample = 0; sample < nsamples; sample++) {
-			double rell = 0.0;
-			for (int ptn = 0; ptn < nptn; ptn++)
-				rell += pattern_lh[ptn] * pllUFBootDataPtr->boot_samples[sample][ptn];
+			double rell = pllUFBootDataPtr->boot_samples->dotProduct(sample, pattern_lh);
 
 			if (rell > pllUFBootDataPtr->boot_logl[sample] + globalParams->ufboot_epsilon ||
 				(rell > pllUFBootDataPtr->boot_logl[sample] - globalParams->ufboot_epsilon &&
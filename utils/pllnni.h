@@ -35,6 +35,7 @@
 extern "C" {
 #include "pll/pllInternal.h"
 }
+#include "tree/bootsamples.h"
 
 typedef struct {
 	nodeptr p;
@@ -229,7 +230,7 @@ typedef struct{
     double * treels_logl; // maintain size == treels_size
 //    char ** treels_newick; // maintain size == treels_size
     double ** treels_ptnlh; // maintain size == treels_size
-    int ** boot_samples;
+    BootSamples * boot_samples; // pattern counts in PLL pattern order
     double * boot_logl;
     int * boot_counts;
     StrVector boot_trees;
@@ -285,6 +285,24 @@ __inline uint64_t getMemorySize( )
 }
 
 
+/**
+ * @return peak resident set size of this process in bytes, or 0 if unknown
+ */
+__inline uint64_t getPeakMemoryUsage() {
+#ifdef HAVE_GETRUSAGE
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__) && defined(__MACH__)
+	return (uint64_t)usage.ru_maxrss; /* bytes on macOS */
+#else
+	return (uint64_t)usage.ru_maxrss * 1024; /* kilobytes elsewhere */
+#endif
+#else
+	return 0;
+#endif
+}
+
 #define HOW_LONG(x) \
 { std::cout.precision(6); double startTime = getRealTime(); \
 x; \
@@ -1107,10 +1107,15 @@ void parseArg(int argc, char *argv[], Params &params) {
     params.gurobi_threads = 1;
     params.num_bootstrap_samples = 0;
     params.bootstrap_spec = NULL;
+    params.bootstrap_parallel = false;
+    params.bootstrap_warm_start = false;
+    params.bootstrap_warm_unsuccess = 10;
     params.transfer_bootstrap = 0;
 
     params.aln_file = NULL;
     params.phylip_sequential_format = false;
+    params.stream_alignment = false;
+    params.aln_cache = false;
     params.symtest = SYMTEST_NONE;
     params.symtest_only = false;
     params.symtest_remove = 0;
@@ -1233,6 +1238,14 @@ void parseArg(int argc, char *argv[], Params &params) {
     params.SSE = LK_AVX_FMA;
 #endif
     params.lk_safe_scaling = false;
+    params.lk_float = false;
+    params.site_repeats = false;
+    params.lk_tasks = false;
+    params.nni_workers = 0;
+    params.init_workers = 0;
+    params.search_walkers = 0;
+    params.pars_incremental = true;
+    params.pars_spr = false;
     params.numseq_safe_scaling = 2000;
     params.kernel_nonrev = false;
     params.print_site_lh = WSL_NONE;
@@ -1341,6 +1354,9 @@ void parseArg(int argc, char *argv[], Params &params) {
     params.num_threads = 1;
     params.num_threads_max = 10000;
     params.openmp_by_model = false;
+    params.modelfinder_reuse_tree = true;
+    params.modelfinder_warm_start = true;
+    params.modelfinder_abort_margin = 10.0;
     params.model_test_criterion = MTC_BIC;
 //    params.model_test_stop_rule = MTC_ALL;
     params.model_test_sample_size = 0;
@@ -1384,6 +1400,7 @@ void parseArg(int argc, char *argv[], Params &params) {
     params.checkpoint_dump_interval = 60;
     params.force_unfinished = false;
     params.print_all_checkpoints = false;
+    params.checkpoint_binary = false;
     params.suppress_output_flags = 0;
     params.ufboot2corr = false;
     params.u2c_nni5 = false;
@@ -2286,6 +2303,14 @@ void parseArg(int argc, char *argv[], Params &params) {
                 params.phylip_sequential_format = true;
                 continue;
             }
+            if (strcmp(argv[cnt], "--stream-aln") == 0) {
+                params.stream_alignment = true;
+                continue;
+            }
+            if (strcmp(argv[cnt], "--aln-cache") == 0) {
+                params.aln_cache = true;
+                continue;
+            }
             if (strcmp(argv[cnt], "--symtest") == 0) {
                 params.symtest = SYMTEST_MAXDIV;
                 continue;
@@ -3311,6 +3336,61 @@ void parseArg(int argc, char *argv[], Params &params) {
 				continue;
 			}
 
+			if (strcmp(argv[cnt], "--lk-float") == 0) {
+				params.lk_float = true;
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--site-repeats") == 0) {
+				params.site_repeats = true;
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--lk-tasks") == 0) {
+				params.lk_tasks = true;
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--nni-workers") == 0) {
+				cnt++;
+				if (cnt >= argc)
+					throw "Use --nni-workers NUM";
+				params.nni_workers = convert_int(argv[cnt]);
+				if (params.nni_workers < 0)
+					throw "Non-negative --nni-workers expected";
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--init-workers") == 0) {
+				cnt++;
+				if (cnt >= argc)
+					throw "Use --init-workers NUM";
+				params.init_workers = convert_int(argv[cnt]);
+				if (params.init_workers < 0)
+					throw "Non-negative --init-workers expected";
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--search-walkers") == 0) {
+				cnt++;
+				if (cnt >= argc)
+					throw "Use --search-walkers NUM";
+				params.search_walkers = convert_int(argv[cnt]);
+				if (params.search_walkers < 0)
+					throw "Non-negative --search-walkers expected";
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--pars-no-incr") == 0) {
+				params.pars_incremental = false;
+				continue;
+			}
+
+			if (strcmp(argv[cnt], "--pars-spr") == 0) {
+				params.pars_spr = true;
+				continue;
+			}
+
 			if (strcmp(argv[cnt], "-safe-seq") == 0) {
 				cnt++;
 				if (cnt >= argc)
@@ -3620,6 +3700,27 @@ void parseArg(int argc, char *argv[], Params &params) {
 				continue;
 			}
             
+            if (strcmp(argv[cnt], "--boot-parallel") == 0) {
+                params.bootstrap_parallel = true;
+                continue;
+            }
+
+            if (strcmp(argv[cnt], "--boot-warm") == 0) {
+                params.bootstrap_warm_start = true;
+                continue;
+            }
+
+            if (strcmp(argv[cnt], "--boot-warm-stop") == 0) {
+                cnt++;
+                if (cnt >= argc)
+                    throw "Use --boot-warm-stop NUM";
+                params.bootstrap_warm_unsuccess = convert_int(argv[cnt]);
+                if (params.bootstrap_warm_unsuccess < 0)
+                    throw "--boot-warm-stop must not be negative";
+                params.bootstrap_warm_start = true;
+                continue;
+            }
+
             if (strcmp(argv[cnt], "--subsample") == 0) {
                 cnt++;
                 if (cnt >= argc)
@@ -4453,6 +4554,24 @@ void parseArg(int argc, char *argv[], Params &params) {
                 continue;
             }
 
+            if (strcmp(argv[cnt], "--mf-no-reuse") == 0) {
+                params.modelfinder_reuse_tree = false;
+                continue;
+            }
+
+            if (strcmp(argv[cnt], "--mf-no-warm-start") == 0) {
+                params.modelfinder_warm_start = false;
+                continue;
+            }
+
+            if (strcmp(argv[cnt], "--mf-abort-margin") == 0) {
+                cnt++;
+                if (cnt >= argc)
+                    throw "Use --mf-abort-margin <score_margin>";
+                params.modelfinder_abort_margin = convert_double(argv[cnt]);
+                continue;
+            }
+
             if (strcmp(argv[cnt], "-pars_ins") == 0) {
 				params.reinsert_par = true;
 				continue;
@@ -5095,6 +5214,11 @@ void parseArg(int argc, char *argv[], Params &params) {
                 params.print_all_checkpoints = true;
                 continue;
             }
+
+            if (strcmp(argv[cnt], "--ckp-bin") == 0) {
+                params.checkpoint_binary = true;
+                continue;
+            }
             
 			if (strcmp(argv[cnt], "--no-log") == 0) {
 				params.suppress_output_flags |= OUT_LOG;
@@ -5699,11 +5823,19 @@ void usage_iqtree(char* argv[], bool full_command) {
     << "  -s FILE[,...,FILE]   PHYLIP/FASTA/NEXUS/CLUSTAL/MSF alignment file(s)" << endl
     << "  -s DIR               Directory of alignment files" << endl
     << "  --seqtype STRING     BIN, DNA, AA, NT2AA, CODON, MORPH (default: auto-detect)" << endl
+    << "  --stream-aln         Read PHYLIP/FASTA alignment memory-mapped in column blocks" << endl
+    << "  --aln-cache          Write/restore binary alignment cache PREFIX.alncache" << endl
     << "  -t FILE|PARS|RAND    Starting tree (default: 99 parsimony and BIONJ)" << endl
     << "  -o TAX[,...,TAX]     Outgroup taxon (list) for writing .treefile" << endl
     << "  --prefix STRING      Prefix for all output files (default: aln/partition)" << endl
     << "  --seed NUM           Random seed number, normally used for debugging purpose" << endl
     << "  --safe               Safe likelihood kernel to avoid numerical underflow" << endl
+    << "  --lk-float           Single-precision partial likelihoods during tree search" << endl
+    << "  --site-repeats       Skip partial likelihoods of repeated subtree site patterns" << endl
+    << "  --lk-tasks           Compute independent subtrees as parallel tasks (-nt > 1)" << endl
+    << "  --nni-workers NUM    Evaluate NNI branches on NUM worker trees in parallel (at most -nt)" << endl
+    << "  --init-workers NUM   Evaluate initial trees on NUM worker trees in parallel" << endl
+    << "  --search-walkers NUM Run NUM perturbation walkers in parallel per search round" << endl
     << "  --mem NUM[G|M|%]     Maximal RAM usage in GB | MB | %" << endl
     << "  --runs NUM           Number of indepedent runs (default: 1)" << endl
     << "  -v, --verbose        Verbose mode, printing more messages to screen" << endl
@@ -5720,6 +5852,7 @@ void usage_iqtree(char* argv[], bool full_command) {
     << "  --redo-tree          Restore ModelFinder and only redo tree search" << endl
     << "  --undo               Revoke finished run, used when changing some options" << endl
     << "  --cptime NUM         Minimum checkpoint interval (default: 60 sec and adapt)" << endl
+    << "  --ckp-bin            Write incremental binary checkpoint in the background" << endl
     << endl << "PARTITION MODEL:" << endl
     << "  -p FILE|DIR          NEXUS/RAxML partition file or directory with alignments" << endl
     << "                       Edge-linked proportional partition model" << endl
@@ -5741,6 +5874,8 @@ void usage_iqtree(char* argv[], bool full_command) {
     << "  --nstop NUM          Number of unsuccessful iterations to stop (default: 100)" << endl
     << "  --perturb NUM        Perturbation strength for randomized NNI (default: 0.5)" << endl
     << "  --radius NUM         Radius for parsimony SPR search (default: 6)" << endl
+    << "  --pars-no-incr       Rescore the whole tree for every taxon added to parsimony trees" << endl
+    << "  --pars-spr           Improve parsimony trees by SPR moves within --radius" << endl
     << "  --allnni             Perform more thorough NNI search (default: OFF)" << endl
     << "  -g FILE              (Multifurcating) topological constraint tree file" << endl
     << "  --fast               Fast search to resemble FastTree" << endl
@@ -5772,6 +5907,9 @@ void usage_iqtree(char* argv[], bool full_command) {
     << "  --jack-prop NUM      Subsampling proportion for jackknife (default: 0.5)" << endl
     << "  --bcon NUM           Replicates for bootstrap + consensus tree" << endl
     << "  --bonly NUM          Replicates for bootstrap only" << endl
+    << "  --boot-parallel      Run replicates as independent jobs on MPI workers" << endl
+    << "  --boot-warm          Start replicates from ML tree and model, reduced search" << endl
+    << "  --boot-warm-stop NUM Unsuccessful iterations to stop --boot-warm (default: 10)" << endl
 #ifdef USE_BOOSTER
     << "  --tbe                Transfer bootstrap expectation" << endl
 #endif
@@ -5804,6 +5942,10 @@ void usage_iqtree(char* argv[], bool full_command) {
     << "  --merit AIC|AICc|BIC  Akaike|Bayesian information criterion (default: BIC)" << endl
 //            << "  -msep                Perform model selection and then rate selection" << endl
     << "  --mtree              Perform full tree search for every model" << endl
+    << "  --mf-no-reuse        Build a new tree for every model tested by ModelFinder" << endl
+    << "  --mf-no-warm-start   Do not start models from the parameters of nested models" << endl
+    << "  --mf-abort-margin NUM Stop optimizing a model that cannot beat the best score" << endl
+    << "                       plus NUM under AIC, AICc and BIC (default: 10, <0: off)" << endl
     << "  --madd STR,...       List of mixture models to consider" << endl
     << "  --mdef FILE          Model definition NEXUS file (see Manual)" << endl
     << "  --modelomatic        Find best codon/protein/DNA models (Whelan et al. 2015)" << endl
@@ -899,6 +899,15 @@ public:
     /** true if sequential phylip format is used, default: false (interleaved format) */
     bool phylip_sequential_format;
 
+    /**
+        true to read PHYLIP/FASTA alignments through a memory-mapped file in blocks of
+        columns, without holding all sequences in memory (default: false)
+     */
+    bool stream_alignment;
+
+    /** true to save/restore the compressed alignment in the binary PREFIX.alncache file (default: false) */
+    bool aln_cache;
+
     /**
      SYMTEST_NONE to not perform test of symmetry of Jermiin et al. (default)
      SYMTEST_MAXDIV to perform symmetry test on the pair with maximum divergence
@@ -1736,6 +1745,22 @@ public:
     */
     char *bootstrap_spec;
 
+    /**
+        TRUE to schedule standard bootstrap replicates as independent jobs:
+        MPI workers run different replicates concurrently, and every replicate
+        keeps its own checkpoint so that an interrupted run resumes each replicate
+    */
+    bool bootstrap_parallel;
+
+    /**
+        TRUE to start every standard bootstrap replicate from the ML tree and
+        ML model parameters of the original alignment and run a reduced search
+    */
+    bool bootstrap_warm_start;
+
+    /** number of unsuccessful iterations to stop the reduced search of --boot-warm */
+    int bootstrap_warm_unsuccess;
+
     /** 1 or 2 to perform transfer boostrap expectation (TBE) */
     int transfer_bootstrap;
     
@@ -1838,6 +1863,33 @@ public:
     /** minimum number of sequences to always use safe scaling, default: 2000 */
     int numseq_safe_scaling;
 
+    /** TRUE to store partial likelihoods in single precision during tree search, default: FALSE */
+    bool lk_float;
+
+    /** TRUE to compute partial likelihoods only once per repeated subtree site pattern, default: FALSE */
+    bool site_repeats;
+
+    /** TRUE to compute partial likelihoods of independent subtrees as parallel tasks, default: FALSE */
+    bool lk_tasks;
+
+    /** number of threads evaluating NNI branches concurrently on worker trees, default: 0 (sequential) */
+    int nni_workers;
+
+    /** number of threads evaluating initial trees concurrently on worker trees, default: 0 (sequential) */
+    int init_workers;
+
+    /** number of perturbation walkers running concurrently in every search round, default: 0 (one walker) */
+    int search_walkers;
+
+    /**
+        TRUE (default) to keep the state sets of all branches up-to-date during stepwise addition
+        of parsimony trees, FALSE to recompute them after each inserted taxon
+     */
+    bool pars_incremental;
+
+    /** TRUE to improve parsimony trees by parsimony SPR moves within sprDist, default: FALSE */
+    bool pars_spr;
+
     /** TRUE to force using non-reversible likelihood kernel */
     bool kernel_nonrev;
 
@@ -2195,6 +2247,15 @@ public:
     /** true to parallel ModelFinder by models instead of sites */
     bool openmp_by_model;
 
+    /** true to keep one tree with its likelihood buffers per ModelFinder thread across models */
+    bool modelfinder_reuse_tree;
+
+    /** true to start the parameter optimization of a model from its finished nested model */
+    bool modelfinder_warm_start;
+
+    /** margin added to the best AIC/AICc/BIC before cutting short hopeless ModelFinder models, negative: never */
+    double modelfinder_abort_margin;
+
     /** either MTC_AIC, MTC_AICc, MTC_BIC */
     ModelTestCriterion model_test_criterion;
 
@@ -2304,6 +2365,9 @@ public:
     /** TRUE to print checkpoints to 1.ckp.gz, 2.ckp.gz,... */
     bool print_all_checkpoints;
 
+    /** TRUE to write the checkpoint as append-only binary log PREFIX.ckp.bin by a background thread */
+    bool checkpoint_binary;
+
     /** control output files to be written
      * OUT_LOG
      * OUT_TREEFILE